@@ -0,0 +1,130 @@
+#include "actionlog.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Garante em tempo de compilação que o cabeçalho tem 48 bytes (40 até count, como no ARKLOG1/2)
+typedef char ActionLogHeaderSizeCheck[(sizeof(ActionLogFileHeader) == 48) ? 1 : -1];
+typedef char ActionLogHeaderV2Check[(offsetof(ActionLogFileHeader, levelHash) == 40) ? 1 : -1];
+
+void actionlog_begin(ActionLog *log, SimState *sim) {
+    log->dt = sim->dt;
+    log->collision = sim->collision;
+    log->rngState = sim->rng.state;
+    log->finalHash = 0;
+    log->levelHash = level_hash(sim->level);
+    log->count = 0;
+    sim->log = log;
+}
+
+void actionlog_end(ActionLog *log, SimState *sim) {
+    sim->log = NULL;
+    log->finalHash = sim_hash(sim);
+}
+
+// Bytes ocupados por n ações empacotadas
+static size_t PackedBytes(long n) {
+    return (size_t)((n + 3) / 4);
+}
+
+bool actionlog_push(ActionLog *log, int action) {
+    if (log->count == log->capacity) {
+        long capacity = log->capacity ? log->capacity * 2 : 16384;
+        uint8_t *actions = (uint8_t *)realloc(log->actions, PackedBytes(capacity));
+        if (!actions) return false;
+        log->actions = actions;
+        log->capacity = capacity;
+    }
+    // O primeiro passo de cada byte sobrescreve o que sobrou da gravação anterior
+    long i = log->count++;
+    unsigned shift = (unsigned)(i & 3) * 2;
+    if (shift == 0) log->actions[i >> 2] = (uint8_t)action;
+    else log->actions[i >> 2] |= (uint8_t)(action << shift);
+    return true;
+}
+
+void actionlog_free(ActionLog *log) {
+    free(log->actions);
+    memset(log, 0, sizeof(*log));
+}
+
+bool actionlog_level_matches(const ActionLog *log, const Level *level) {
+    return log->levelHash == 0 || log->levelHash == level_hash(level);
+}
+
+uint64_t actionlog_replay(const ActionLog *log, const Level *level, SimState *sim) {
+    sim_init(sim, log->dt, 0);
+    if (!actionlog_level_matches(log, level)) return 0;
+    sim->collision = log->collision;
+    sim->level = level ? level : level_builtin();
+    sim->rng.state = log->rngState;
+    sim_reset(sim);
+    for (long i = 0; i < log->count; i++) {
+        sim_step(sim, actionlog_get(log, i));
+    }
+    return sim_hash(sim);
+}
+
+bool actionlog_save(const ActionLog *log, const char *filename) {
+    ActionLogFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ACTIONLOG_MAGIC, sizeof(header.magic));
+    header.dt = log->dt;
+    header.collision = (uint32_t)log->collision;
+    header.rngState = log->rngState;
+    header.finalHash = log->finalHash;
+    header.count = log->count;
+    header.levelHash = log->levelHash;
+
+    FILE *file = fopen(filename, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    size_t bytes = PackedBytes(log->count);
+    if (ok && bytes > 0) ok = fwrite(log->actions, 1, bytes, file) == bytes;
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+bool actionlog_load(ActionLog *log, const char *filename) {
+    memset(log, 0, sizeof(*log));
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+
+    // Os 40 primeiros bytes são comuns às três versões; só o ARKLOG3 tem o nível
+    ActionLogFileHeader header;
+    memset(&header, 0, sizeof(header));
+    bool ok = fread(&header, offsetof(ActionLogFileHeader, levelHash), 1, file) == 1 && header.count >= 0;
+    bool v1 = ok && memcmp(header.magic, ACTIONLOG_MAGIC_V1, sizeof(header.magic)) == 0;
+    bool v2 = ok && memcmp(header.magic, ACTIONLOG_MAGIC_V2, sizeof(header.magic)) == 0;
+    ok = ok && (v1 || v2 || memcmp(header.magic, ACTIONLOG_MAGIC, sizeof(header.magic)) == 0);
+    if (ok && !v1 && !v2) ok = fread(&header.levelHash, sizeof(header.levelHash), 1, file) == 1;
+    if (ok && header.count > 0) {
+        size_t bytes = v1 ? (size_t)header.count : PackedBytes((long)header.count);
+        log->actions = (uint8_t *)malloc(bytes);
+        ok = log->actions && fread(log->actions, 1, bytes, file) == bytes;
+        if (ok && v1) {
+            // Formato antigo: um byte por ação, empacotado aqui mesmo (o destino nunca passa da origem)
+            for (int64_t i = 0; i < header.count && ok; i++) {
+                uint8_t action = log->actions[i];
+                ok = action <= ACTION_RIGHT;
+                if (i % 4 == 0) log->actions[i / 4] = action;
+                else log->actions[i / 4] |= (uint8_t)(action << ((i % 4) * 2));
+            }
+        }
+    }
+    fclose(file);
+    // Em 2 bits só o valor 3 é inválido
+    for (int64_t i = 0; ok && !v1 && i < header.count; i++) ok = actionlog_get(log, (long)i) <= ACTION_RIGHT;
+    if (!ok) {
+        actionlog_free(log);
+        return false;
+    }
+    log->dt = header.dt;
+    log->collision = (int)header.collision;
+    log->rngState = header.rngState;
+    log->finalHash = header.finalHash;
+    log->levelHash = header.levelHash;
+    log->count = log->capacity = (long)header.count;
+    return true;
+}
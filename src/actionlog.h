@@ -0,0 +1,126 @@
+#ifndef ACTIONLOG_H
+#define ACTIONLOG_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Registro de ações de um episódio. A simulação é determinística (passo fixo
+ * e gerador explícito), então o estado do gerador no início do episódio mais
+ * a sequência de ações reproduzem o jogo bit a bit.
+ *
+ * As três ações cabem em 2 bits: o registro guarda 4 passos por byte (o
+ * passo i nos bits 2*(i%4) do byte i/4), o bastante para ficar ligado em
+ * todo episódio de treino.
+ *
+ * O cabeçalho guarda também a identidade do nível (level_hash): reproduzir
+ * em outro nível divergiria, então é recusado.
+ *
+ * Arquivo: [ActionLogFileHeader][(count + 3) / 4 bytes de ações empacotadas]
+ * (ARKLOG2, sem o nível, e ARKLOG1, um byte por ação, ainda são aceitos na
+ * leitura, em qualquer nível)
+ */
+
+#define ACTIONLOG_MAGIC   "ARKLOG3"     // 7 caracteres + '\0'
+#define ACTIONLOG_MAGIC_V2 "ARKLOG2"
+#define ACTIONLOG_MAGIC_V1 "ARKLOG1"
+
+typedef struct ActionLog {
+    float dt;               // passo fixo do episódio
+    int collision;          // modo de colisão (SIM_COLLISION_*)
+    uint64_t rngState;      // gerador do jogo antes do sim_reset do episódio
+    uint64_t finalHash;     // sim_hash ao fim da gravação (0 = desconhecido)
+    uint64_t levelHash;     // level_hash do nível gravado (0 = desconhecido: ARKLOG1/2)
+    uint8_t *actions;       // 4 ações por byte, 2 bits cada
+    long count;             // passos gravados
+    long capacity;          // passos que cabem em actions
+} ActionLog;
+
+// Cabeçalho do arquivo (48 bytes, campos em endianness nativa; ARKLOG1/2
+// terminam em count, com 40 bytes)
+typedef struct {
+    char magic[8];
+    float dt;
+    uint32_t collision;
+    uint64_t rngState;
+    uint64_t finalHash;
+    int64_t count;
+    uint64_t levelHash;
+} ActionLogFileHeader;
+
+/**
+ * Começa a gravar um episódio: guarda o passo e o gerador atuais do jogo e
+ * liga o registro em sim_step. Chame antes do sim_reset que inicia o episódio.
+ * @param log Registro (pode já conter ações de uma gravação anterior).
+ * @param sim Jogo a ser gravado.
+ */
+void actionlog_begin(ActionLog *log, SimState *sim);
+
+/**
+ * Encerra a gravação: desliga o registro e guarda o hash do estado final.
+ * @param log Registro.
+ * @param sim Jogo gravado.
+ */
+void actionlog_end(ActionLog *log, SimState *sim);
+
+/**
+ * Acrescenta uma ação ao registro (chamado por sim_step).
+ * @param log Registro.
+ * @param action Ação aplicada.
+ * @return false se faltou memória (a ação é perdida).
+ */
+bool actionlog_push(ActionLog *log, int action);
+
+/**
+ * Ação aplicada em um passo gravado.
+ * @param log Registro.
+ * @param step Passo, em [0, count).
+ * @return ACTION_LEFT, ACTION_STAY ou ACTION_RIGHT.
+ */
+static inline int actionlog_get(const ActionLog *log, long step) {
+    return (log->actions[step >> 2] >> ((step & 3) * 2)) & 3;
+}
+
+/**
+ * Libera a memória do registro.
+ * @param log Registro.
+ */
+void actionlog_free(ActionLog *log);
+
+/**
+ * Confere se o registro foi gravado no nível dado. Registros sem a identidade
+ * do nível (ARKLOG1/2) passam em qualquer um.
+ * @param log Registro.
+ * @param level Nível (NULL = embutido).
+ * @return true se o nível é o da gravação (ou desconhecido).
+ */
+bool actionlog_level_matches(const ActionLog *log, const Level *level);
+
+/**
+ * Reproduz o episódio gravado em um jogo novo.
+ * @param log Registro.
+ * @param level Nível em que o episódio foi gravado (NULL = embutido).
+ * @param sim Saída com o estado final do jogo reproduzido.
+ * @return sim_hash do estado final, ou 0 se o registro é de outro nível
+ *         (actionlog_level_matches; nada é reproduzido).
+ */
+uint64_t actionlog_replay(const ActionLog *log, const Level *level, SimState *sim);
+
+/**
+ * Salva o registro em arquivo binário.
+ * @param log Registro.
+ * @param filename Caminho do arquivo.
+ * @return true se salvou.
+ */
+bool actionlog_save(const ActionLog *log, const char *filename);
+
+/**
+ * Carrega um registro salvo com actionlog_save.
+ * @param log Registro (zerado; liberar com actionlog_free).
+ * @param filename Caminho do arquivo.
+ * @return true se carregou.
+ */
+bool actionlog_load(ActionLog *log, const char *filename);
+
+#endif // ACTIONLOG_H
@@ -0,0 +1,56 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Sons e shaders embutidos no executável da janela. As tabelas são geradas
+ * no build por tools/embed_assets.c a partir de assets/: cada WAV já vira PCM
+ * de 16 bits (sem parsing na partida, pronto para LoadSoundFromWave) e cada
+ * shader vira o texto GLSL terminado em '\0' (para LoadShaderFromMemory).
+ * Nada depende do diretório de trabalho.
+ */
+
+typedef struct {
+    const char *name;           // nome do arquivo sem extensão ("brick_hit")
+    unsigned int frameCount;
+    unsigned int sampleRate;
+    unsigned int sampleSize;    // sempre 16
+    unsigned int channels;
+    const int16_t *data;        // frameCount × channels amostras
+} EmbeddedSound;
+
+typedef struct {
+    const char *name;           // nome do arquivo sem extensão ("blur")
+    const char *code;
+} EmbeddedShader;
+
+extern const EmbeddedSound embeddedSounds[];
+extern const int embeddedSoundCount;
+extern const EmbeddedShader embeddedShaders[];
+extern const int embeddedShaderCount;
+
+/**
+ * Procura um som embutido.
+ * @param name Nome sem extensão.
+ * @return O som, ou NULL se não existe.
+ */
+static inline const EmbeddedSound *assets_sound(const char *name) {
+    for (int i = 0; i < embeddedSoundCount; i++)
+        if (strcmp(embeddedSounds[i].name, name) == 0) return &embeddedSounds[i];
+    return NULL;
+}
+
+/**
+ * Procura o código de um shader embutido.
+ * @param name Nome sem extensão.
+ * @return Texto GLSL, ou NULL se não existe.
+ */
+static inline const char *assets_shader(const char *name) {
+    for (int i = 0; i < embeddedShaderCount; i++)
+        if (strcmp(embeddedShaders[i].name, name) == 0) return embeddedShaders[i].code;
+    return NULL;
+}
+
+#endif // ASSETS_H
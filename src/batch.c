@@ -0,0 +1,173 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "batch.h"
+#include "brick.h"
+#include "level.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Número de vetores de 4 bytes alocados no bloco do lote (os geradores, de
+// 8 bytes, ocupam dois); os tijolos vêm depois, do tamanho do nível
+#define BATCH_ARRAYS 9
+
+// Elementos por vetor arredondados para múltiplos de uma linha de cache
+static size_t PaddedCount(int n) {
+    return ((size_t)n + 15) & ~(size_t)15;
+}
+
+bool batch_init(BatchEnv *env, int n, float dt, uint64_t seed, const Level *level) {
+    memset(env, 0, sizeof(*env));
+    if (n <= 0) return false;
+    if (!level) level = level_builtin();
+
+    int fieldWords = level->rows * level->words;
+    int gameWords = fieldWords * (level->multiHit ? 1 + LEVEL_HP_BITS : 1);
+    size_t stride = PaddedCount(n) * 4;
+    size_t total = BATCH_ARRAYS * stride + (size_t)n * gameWords * sizeof(uint64_t);
+    void *block = NULL;
+    if (posix_memalign(&block, 64, total) != 0) return false;
+    memset(block, 0, total);
+
+    char *p = (char *)block;
+    env->rng          = (Rng *)p;      p += 2 * stride;
+    env->ballX        = (float *)p;    p += stride;
+    env->ballY        = (float *)p;    p += stride;
+    env->velX         = (float *)p;    p += stride;
+    env->velY         = (float *)p;    p += stride;
+    env->paddleX      = (float *)p;    p += stride;
+    env->score        = (int *)p;      p += stride;
+    env->episodeScore = (int *)p;      p += stride;
+    env->bricks       = (uint64_t *)p;
+    env->block = block;
+    env->n = n;
+    env->dt = (dt > 0.0f) ? dt : SIM_DT;
+    env->level = level;
+    env->fieldWords = fieldWords;
+    env->gameWords = gameWords;
+    env->fieldBottom = level->offsetY + (level->rows - 1) * level->pitchY + level->brickH;
+    for (int i = 0; i < n; i++) rng_seed(&env->rng[i], rng_env_seed(seed, i));
+
+    for (int i = 0; i < n; i++) batch_reset(env, i);
+    return true;
+}
+
+void batch_free(BatchEnv *env) {
+    free(env->block);
+    memset(env, 0, sizeof(*env));
+}
+
+void batch_reset(BatchEnv *env, int i) {
+    Ball ball;
+    Rectangle paddle;
+    CreateBall(&ball, &env->rng[i]);
+    CreatePaddle(&paddle);
+
+    env->ballX[i] = ball.pos.x;
+    env->ballY[i] = ball.pos.y;
+    env->velX[i] = ball.vel.x;
+    env->velY[i] = ball.vel.y;
+    env->paddleX[i] = paddle.x;
+    // Mesmo recomeço de level_reset: bitset inicial e nenhum acerto
+    uint64_t *bricks = env->bricks + (size_t)i * env->gameWords;
+    memcpy(bricks, env->level->alive, (size_t)env->fieldWords * sizeof(uint64_t));
+    memset(bricks + env->fieldWords, 0, (size_t)(env->gameWords - env->fieldWords) * sizeof(uint64_t));
+    env->score[i] = 0;
+}
+
+void batch_get(const BatchEnv *env, int i, Rectangle *paddle, Ball *ball) {
+    CreatePaddle(paddle);
+    paddle->x = env->paddleX[i];
+    ball->pos = (Vector2){ env->ballX[i], env->ballY[i] };
+    ball->vel = (Vector2){ env->velX[i], env->velY[i] };
+    ball->radius = BALL_R;
+}
+
+// Limita v a [lo, hi] sem comparações condicionais (mantém o laço vetorizável)
+static inline float Clampf(float v, float lo, float hi) {
+    v = v < lo ? lo : v;
+    return v > hi ? hi : v;
+}
+
+// Paddle, integração da bola, bordas e colisão com o paddle (vetorizável).
+// Os vetores vêm como parâmetros restrict para o compilador dispensar
+// testes de aliasing em tempo de execução.
+static void StepKinematics(int n, float dt, const int *restrict actions,
+                           float *restrict bx, float *restrict by,
+                           float *restrict vx, float *restrict vy,
+                           float *restrict px, unsigned *restrict events) {
+    const float r = BALL_R;
+    const float paddleY0 = SCREEN_H - 40;
+    const float paddleY1 = paddleY0 + PADDLE_H;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        // Paddle: mesmo arredondamento para inteiro de ExecuteAction
+        int ipx = (int)(px[i] + (float)(actions[i] - ACTION_STAY) * PADDLE_SPEED * dt);
+        ipx = ipx < 0 ? 0 : ipx;
+        ipx = ipx > SCREEN_W - PADDLE_W ? SCREEN_W - PADDLE_W : ipx;
+        float p = (float)ipx;
+        px[i] = p;
+
+        // Movimento da bola
+        float x = bx[i] + vx[i] * dt;
+        float y = by[i] + vy[i] * dt;
+
+        // Colisões com bordas (operadores sem curto-circuito para não gerar desvios)
+        int wallX = (x <= r) | (x >= SCREEN_W - r);
+        float nvx = wallX ? -vx[i] : vx[i];
+        float nvy = (y <= r) ? -vy[i] : vy[i];
+        unsigned ev = (y >= SCREEN_H + r) ? SIM_EVENT_GAME_OVER : 0u;
+
+        // Colisão com paddle (ponto mais próximo do retângulo)
+        float cx = Clampf(x, p, p + PADDLE_W);
+        float cy = Clampf(y, paddleY0, paddleY1);
+        float dx = x - cx;
+        float dy = y - cy;
+        int hit = (dx*dx + dy*dy) <= r*r;
+        float upVy = -fabsf(nvy);
+        float hitVx = 300 * ((x - (p + PADDLE_W / 2.0f)) / (PADDLE_W / 2.0f));
+        nvy = hit ? upVy : nvy;
+        nvx = hit ? hitVx : nvx;
+        ev |= hit ? SIM_EVENT_PADDLE_HIT : 0u;
+
+        bx[i] = x;
+        by[i] = y;
+        vx[i] = nvx;
+        vy[i] = nvy;
+        events[i] = ev;
+    }
+}
+
+// Colisão com tijolos: só os jogos com a bola na altura do campo são testados
+// (escalar, poucos jogos por passo; o teste por células não depende do nível)
+static void StepBricks(BatchEnv *env, unsigned *events) {
+    const Level *level = env->level;
+    const float limit = env->fieldBottom + BALL_R;
+    for (int i = 0; i < env->n; i++) {
+        if (env->ballY[i] > limit) continue;
+        uint64_t *alive = env->bricks + (size_t)i * env->gameWords;
+        uint64_t *hits[LEVEL_HP_BITS];
+        for (int p = 0; p < LEVEL_HP_BITS; p++) hits[p] = level->multiHit ? alive + (size_t)(p + 1) * env->fieldWords : alive;
+
+        Ball ball = { { env->ballX[i], env->ballY[i] }, { env->velX[i], env->velY[i] }, BALL_R };
+        if (!CollideBrickBits(level, alive, hits, &ball, &env->score[i])) continue;
+        events[i] |= SIM_EVENT_BRICK_HIT;
+        env->velX[i] = ball.vel.x;
+        env->velY[i] = ball.vel.y;
+    }
+}
+
+void batch_step(BatchEnv *env, const int *actions, unsigned *events) {
+    StepKinematics(env->n, env->dt, actions, env->ballX, env->ballY,
+                   env->velX, env->velY, env->paddleX, events);
+    StepBricks(env, events);
+
+    // Jogos encerrados recomeçam já no próximo passo
+    for (int i = 0; i < env->n; i++) {
+        if (events[i] & SIM_EVENT_GAME_OVER) {
+            env->episodeScore[i] = env->score[i];
+            batch_reset(env, i);
+        }
+    }
+}
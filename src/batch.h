@@ -0,0 +1,86 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "defs.h"
+#include "sim.h"
+#include <stdint.h>
+
+/*
+ * Ambiente em lote: N jogos independentes avançados em uma única chamada.
+ * Os dados ficam em structure-of-arrays (um vetor por campo) para que os
+ * laços de integração, bordas e colisão com o paddle sejam vetorizados pelo
+ * compilador. Cada jogo tem a mesma física de sim_step no nível escolhido;
+ * ao perder, o jogo é reiniciado automaticamente no próprio passo (o evento
+ * SIM_EVENT_GAME_OVER é reportado e a pontuação final fica em episodeScore).
+ *
+ * Os tijolos de cada jogo ocupam só as palavras que o nível usa: o bitset de
+ * vivos (rows * words) e, em níveis com vários pontos de vida, os planos de
+ * acertos logo depois. As colisões com tijolos usam o mesmo teste por
+ * células de CreateBricks, só para os jogos com a bola na altura do campo.
+ */
+
+typedef struct {
+    int n;              // número de jogos
+    float dt;           // passo fixo comum a todos os jogos
+    const Level *level; // nível de todos os jogos (imagem compartilhada)
+
+    // Estado por jogo (SoA)
+    float *ballX, *ballY;
+    float *velX, *velY;
+    float *paddleX;
+    int *score;
+    int *episodeScore;  // pontuação do último episódio encerrado
+    uint64_t *bricks;   // gameWords palavras por jogo: vivos e, se multiHit, acertos
+    int fieldWords;     // palavras de um bitset (level->rows * level->words)
+    int gameWords;      // fieldWords * (1 + planos de acertos)
+
+    float fieldBottom;  // y da base da última fileira
+    Rng *rng;           // gerador de cada jogo (semente rng_env_seed(seed, i)),
+                        // usado ao reiniciá-lo: cada jogo é reproduzível sozinho
+
+    void *block;        // bloco único que contém todos os vetores acima
+} BatchEnv;
+
+/**
+ * Aloca e reinicia um lote de n jogos.
+ * @param env Lote a ser inicializado.
+ * @param n Número de jogos.
+ * @param dt Passo fixo (<= 0 usa SIM_DT).
+ * @param seed Semente da execução; o jogo i usa rng_env_seed(seed, i), a mesma
+ *             sequência de sim_init(sim, dt, rng_env_seed(seed, i)).
+ * @param level Nível jogado (NULL = embutido); precisa viver enquanto o lote existir.
+ * @return true se a alocação funcionou.
+ */
+bool batch_init(BatchEnv *env, int n, float dt, uint64_t seed, const Level *level);
+
+/**
+ * Libera a memória do lote.
+ * @param env Lote.
+ */
+void batch_free(BatchEnv *env);
+
+/**
+ * Reinicia o jogo i do lote.
+ * @param env Lote.
+ * @param i Índice do jogo.
+ */
+void batch_reset(BatchEnv *env, int i);
+
+/**
+ * Copia o jogo i para uma estrutura Ball/paddle (ex.: para q_encode).
+ * @param env Lote.
+ * @param i Índice do jogo.
+ * @param paddle Saída com o paddle.
+ * @param ball Saída com a bola.
+ */
+void batch_get(const BatchEnv *env, int i, Rectangle *paddle, Ball *ball);
+
+/**
+ * Avança todos os jogos um passo.
+ * @param env Lote.
+ * @param actions Ação de cada jogo (n elementos).
+ * @param events Saída com os SIM_EVENT_* de cada jogo (n elementos).
+ */
+void batch_step(BatchEnv *env, const int *actions, unsigned *events);
+
+#endif // BATCH_H
@@ -0,0 +1,697 @@
+/********************************************************************
+ * Arkanoid — benchmarks dos caminhos quentes da simulação e do bot
+ * Saída em JSON (ns/op, passos/s e alocações) para comparar commits.
+ ********************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "defs.h"
+#include "sim.h"
+#include "brick.h"
+#include "bot.h"
+#include "batch.h"
+#include "train.h"
+#include "replaybuf.h"
+#include "linear.h"
+#include "actionlog.h"
+#include "policy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Amostras pré-geradas por benchmark (potência de 2 para indexar com máscara)
+#define BENCH_SAMPLES 4096
+#define BENCH_MASK    (BENCH_SAMPLES - 1)
+
+// Repetições de cada medição; o resultado é a mais rápida (menos ruído)
+#define BENCH_REPEATS 5
+
+// Jogos do benchmark de lote
+#define BENCH_BATCH 256
+
+/* ---------- Contagem de alocações ----------
+ * Com BENCH_WRAP_MALLOC o link usa -Wl,--wrap=... e toda alocação do
+ * programa (inclusive do núcleo) passa por aqui. Sem isso, as colunas de
+ * alocação saem como null. */
+static long allocCount;
+static long allocBytes;
+
+#ifdef BENCH_WRAP_MALLOC
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+int __real_posix_memalign(void **ptr, size_t align, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocBytes, (long)size, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocBytes, (long)(n * size), __ATOMIC_RELAXED);
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocBytes, (long)size, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+int __wrap_posix_memalign(void **ptr, size_t align, size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocBytes, (long)size, __ATOMIC_RELAXED);
+    return __real_posix_memalign(ptr, align, size);
+}
+#endif
+
+// Resultado de uma medição
+typedef struct {
+    const char *name;
+    double nsPerOp;         // tempo por operação (ou por passo)
+    long ops;               // operações na repetição mais rápida
+    long allocs;            // alocações por repetição (-1 = não medido)
+    long allocBytes;        // bytes alocados por repetição (-1 = não medido)
+} BenchResult;
+
+// Um benchmark executa ops operações; o valor devolvido evita que o
+// compilador descarte o trabalho
+typedef unsigned (*BenchFn)(void *ctx, long ops);
+
+static volatile unsigned benchSink;
+static double benchMinTime = 0.2;   // segundos por repetição
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Calibra o número de operações para ~benchMinTime e mede BENCH_REPEATS vezes
+static BenchResult RunBench(const char *name, BenchFn fn, void *ctx) {
+    long ops = 1024;
+    for (;;) {
+        double t0 = NowSeconds();
+        benchSink += fn(ctx, ops);
+        double t = NowSeconds() - t0;
+        if (t >= benchMinTime / 4 || ops >= (1L << 40)) {
+            if (t > 0.0) ops = (long)(ops * (benchMinTime / t)) + 1;
+            break;
+        }
+        ops *= 4;
+    }
+
+    BenchResult r = { name, 0.0, ops, -1, -1 };
+    double best = -1.0;
+    for (int k = 0; k < BENCH_REPEATS; k++) {
+        long count0 = __atomic_load_n(&allocCount, __ATOMIC_RELAXED);
+        long bytes0 = __atomic_load_n(&allocBytes, __ATOMIC_RELAXED);
+        double t0 = NowSeconds();
+        benchSink += fn(ctx, ops);
+        double t = NowSeconds() - t0;
+        if (best < 0.0 || t < best) best = t;
+#ifdef BENCH_WRAP_MALLOC
+        r.allocs = __atomic_load_n(&allocCount, __ATOMIC_RELAXED) - count0;
+        r.allocBytes = __atomic_load_n(&allocBytes, __ATOMIC_RELAXED) - bytes0;
+#else
+        (void)count0;
+        (void)bytes0;
+#endif
+    }
+    r.nsPerOp = best * 1e9 / (double)ops;
+    fprintf(stderr, "%-28s %10.2f ns/op\n", name, r.nsPerOp);
+    return r;
+}
+
+/* ---------- encode_state / choose_action / q_learning_update ---------- */
+
+typedef struct {
+    Rectangle paddle[BENCH_SAMPLES];
+    Ball ball[BENCH_SAMPLES];
+    int state[BENCH_SAMPLES];
+    int action[BENCH_SAMPLES];
+    int next[BENCH_SAMPLES];
+    float reward[BENCH_SAMPLES];
+    QTable *Q;
+    Policy policy;      // política compilada de Q (benchmark policy_action)
+    Rng rng;
+} AgentCtx;
+
+static void InitAgentCtx(AgentCtx *ctx, uint64_t seed) {
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        CreatePaddle(&ctx->paddle[i]);
+        ctx->paddle[i].x = rng_float(&rng) * (SCREEN_W - PADDLE_W);
+        ctx->ball[i].pos = (Vector2){ rng_float(&rng) * SCREEN_W, rng_float(&rng) * SCREEN_H };
+        ctx->ball[i].vel = (Vector2){ rng_range(&rng, -300, 300), rng_range(&rng, -240, 240) };
+        ctx->ball[i].radius = BALL_R;
+        ctx->state[i] = q_encode(ctx->Q, ctx->paddle[i], ctx->ball[i]);
+        ctx->action[i] = rng_range(&rng, 0, N_ACTIONS - 1);
+        ctx->next[i] = (int)(rng_next(&rng) % (uint32_t)ctx->Q->nStates);
+        ctx->reward[i] = rng_float(&rng) * 2.0f - 1.0f;
+    }
+    for (int s = 0; s < ctx->Q->nStates; s++) {
+        float *row = q_row(ctx->Q, s);
+        for (int a = 0; a < N_ACTIONS; a++) row[a] = rng_float(&rng);
+    }
+    rng_seed(&ctx->rng, seed + 1);
+}
+
+// Discretização padrão inline, sem passar pelo descritor
+STATE_ENCODER(EncodeDefault, STATE_SPEC)
+
+static unsigned BenchEncodeState(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        acc += (unsigned)EncodeDefault(ctx->paddle[k], ctx->ball[k]);
+    }
+    return acc;
+}
+
+// A mesma codificação pelo ponteiro do descritor, como no treino
+static unsigned BenchEncodeDispatch(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        acc += (unsigned)q_encode(ctx->Q, ctx->paddle[k], ctx->ball[k]);
+    }
+    return acc;
+}
+
+// Outras discretizações instanciadas no mesmo binário, para comparar o custo
+STATE_ENCODER(EncodeCoarse, STATE_SPEC_COARSE)
+STATE_ENCODER(EncodeNearPaddle, STATE_SPEC_NEAR_PADDLE)
+
+static unsigned BenchEncodeCoarse(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        acc += (unsigned)EncodeCoarse(ctx->paddle[k], ctx->ball[k]);
+    }
+    return acc;
+}
+
+static unsigned BenchEncodeNearPaddle(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        acc += (unsigned)EncodeNearPaddle(ctx->paddle[k], ctx->ball[k]);
+    }
+    return acc;
+}
+
+// Referência: a codificação antiga, com uma divisão por dimensão
+static unsigned BenchEncodeDivide(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    const int nPaddleX = (int)ctx->Q->spec->bins[0], nBallX = (int)ctx->Q->spec->bins[1];
+    const int nBallY = (int)ctx->Q->spec->bins[2], nBallVx = (int)ctx->Q->spec->bins[3];
+    const int nBallVy = (int)ctx->Q->spec->bins[4];
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        Rectangle paddle = ctx->paddle[k];
+        Ball ball = ctx->ball[k];
+        int px = discretize(paddle.x, 0, SCREEN_W - PADDLE_W, nPaddleX);
+        int bx = discretize(ball.pos.x, 0, SCREEN_W, nBallX);
+        int by = discretize(ball.pos.y, 0, SCREEN_H, nBallY);
+        acc += (unsigned)((((px * nBallX + bx) * nBallY + by) * nBallVx + sign_bin(ball.vel.x)) * nBallVy
+                          + sign_bin(ball.vel.y));
+    }
+    return acc;
+}
+
+static unsigned BenchChooseAction(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        acc += (unsigned)choose_action(ctx->Q, ctx->state[i & BENCH_MASK], 0.1f, &ctx->rng);
+    }
+    return acc;
+}
+
+// Ação gulosa lida da Q-table (3 floats por decisão)
+static unsigned BenchGreedyAction(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) acc += (unsigned)greedy_action(ctx->Q, ctx->state[i & BENCH_MASK]);
+    return acc;
+}
+
+// A mesma ação lida da política compilada (2 bits por estado)
+static unsigned BenchPolicyAction(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) acc += (unsigned)policy_action(&ctx->policy, ctx->state[i & BENCH_MASK]);
+    return acc;
+}
+
+static unsigned BenchQUpdate(void *p, long ops) {
+    AgentCtx *ctx = (AgentCtx *)p;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        q_learning_update(ctx->Q, ctx->state[k], ctx->action[k], ctx->reward[k], ctx->next[k],
+                          ALPHA, GAMMA, N_ACTIONS);
+    }
+    return (unsigned)q_value(ctx->Q, ctx->state[0], 0);
+}
+
+/* ---------- Agente linear ---------- */
+
+typedef struct {
+    AgentCtx *agent;
+    LinearQ L;
+    float phi[BENCH_SAMPLES][LINEAR_FEATURES] __attribute__((aligned(32)));
+} LinearCtx;
+
+static unsigned BenchLinearFeatures(void *p, long ops) {
+    LinearCtx *ctx = (LinearCtx *)p;
+    float phi[LINEAR_FEATURES] __attribute__((aligned(32)));
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        linear_features(ctx->agent->paddle[k], ctx->agent->ball[k], phi);
+        acc += (unsigned)phi[7];
+    }
+    return acc;
+}
+
+static unsigned BenchLinearValues(void *p, long ops) {
+    LinearCtx *ctx = (LinearCtx *)p;
+    float q[N_ACTIONS];
+    float acc = 0.0f;
+    for (long i = 0; i < ops; i++) {
+        linear_values(&ctx->L, ctx->phi[i & BENCH_MASK], q);
+        acc += q[0];
+    }
+    return (unsigned)acc;
+}
+
+static unsigned BenchLinearUpdate(void *p, long ops) {
+    LinearCtx *ctx = (LinearCtx *)p;
+    AgentCtx *agent = ctx->agent;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        linear_update(&ctx->L, ctx->phi[k], agent->action[k], agent->reward[k], ALPHA);
+    }
+    return (unsigned)ctx->L.w[0][0];
+}
+
+/* ---------- Buffer de experiência ---------- */
+
+// Capacidade do buffer dos benchmarks e tamanho do minilote
+#define BENCH_REPLAY_CAPACITY (1 << 20)
+#define BENCH_REPLAY_BATCH    32
+
+typedef struct {
+    AgentCtx *agent;
+    ReplayBuffer rb;
+    ReplayBatch batch;
+} ReplayCtx;
+
+static unsigned BenchReplayPush(void *p, long ops) {
+    ReplayCtx *ctx = (ReplayCtx *)p;
+    const AgentCtx *a = ctx->agent;
+    for (long i = 0; i < ops; i++) {
+        int k = (int)(i & BENCH_MASK);
+        replay_push(&ctx->rb, a->state[k], a->action[k], a->reward[k], a->next[k], false);
+    }
+    return (unsigned)replay_size(&ctx->rb);
+}
+
+// Cada operação é um minilote inteiro: amostragem, ordenação e atualização
+static unsigned BenchReplayUpdate(void *p, long ops) {
+    ReplayCtx *ctx = (ReplayCtx *)p;
+    float acc = 0.0f;
+    for (long i = 0; i < ops; i++) {
+        replay_sample(&ctx->rb, &ctx->batch, BENCH_REPLAY_BATCH, &ctx->agent->rng);
+        acc += replay_update(ctx->agent->Q, &ctx->rb, &ctx->batch, ALPHA, GAMMA);
+    }
+    return (unsigned)acc;
+}
+
+/* ---------- CreateBricks ---------- */
+
+typedef struct {
+    const Level *level;
+    BrickField field;           // campo de referência
+    BrickField bricks;          // cópia usada nas medições
+    Ball ball[BENCH_SAMPLES];
+} BrickCtx;
+
+// keep: 1 = todos os tijolos, 2 = xadrez (metade), 3 = só dois tijolos
+static void InitBrickCtx(BrickCtx *ctx, int keep, uint64_t seed) {
+    ctx->level = level_builtin();
+    memset(&ctx->field, 0, sizeof(ctx->field));
+    for (int r = 0; r < ROWS; ++r)
+    for (int c = 0; c < COLS; ++c) {
+        bool alive = true;
+        if (keep == 2) alive = ((r + c) & 1) == 0;
+        else if (keep == 3) alive = (r == 0 && c == 0) || (r == ROWS - 1 && c == COLS - 1);
+        if (alive) ctx->field.alive[r] |= 1ull << c;
+    }
+    ctx->bricks = ctx->field;
+
+    // Bola espalhada pela metade de cima da tela, onde ficam os tijolos
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        ctx->ball[i].pos = (Vector2){ rng_float(&rng) * SCREEN_W, rng_float(&rng) * SCREEN_H * 0.5f };
+        ctx->ball[i].vel = (Vector2){ rng_range(&rng, -300, 300), -240 };
+        ctx->ball[i].radius = BALL_R;
+    }
+}
+
+static unsigned BenchCreateBricks(void *p, long ops) {
+    BrickCtx *ctx = (BrickCtx *)p;
+    int score = 0;
+    for (long i = 0; i < ops; i++) {
+        Ball ball = ctx->ball[i & BENCH_MASK];
+        // Um acerto remove o tijolo: restaura o campo para manter a densidade
+        if (CreateBricks(ctx->level, &ctx->bricks, &ball, &score)) {
+            memcpy(ctx->bricks.alive, ctx->field.alive, ROWS * sizeof(uint64_t));
+        }
+    }
+    return (unsigned)score;
+}
+
+/* ---------- Passos e episódios completos ---------- */
+
+typedef struct {
+    SimState sim;
+    QTable *Q;
+    TrainParams params;
+    Rng rng;
+    TraceAgent traces;      // agente dos benchmarks de Q(λ)/SARSA(λ)
+    LinearQ *linear;        // pesos do benchmark do agente linear
+    ActionLog log;          // gravação do benchmark train_step_recorded
+    long steps;             // passos simulados pela última chamada
+} EpisodeCtx;
+
+// Passos de sim_step com ações aleatórias (reinicia ao perder)
+static unsigned BenchSimStep(void *p, long ops) {
+    EpisodeCtx *ctx = (EpisodeCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        if (ctx->sim.gameOver) sim_reset(&ctx->sim);
+        acc += sim_step(&ctx->sim, (int)(rng_next(&ctx->rng) % N_ACTIONS));
+    }
+    return acc;
+}
+
+// Passos de treino (codifica, escolhe, simula e atualiza)
+static unsigned BenchTrainStep(void *p, long ops) {
+    EpisodeCtx *ctx = (EpisodeCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        if (ctx->sim.gameOver) sim_reset(&ctx->sim);
+        acc += train_step(ctx->Q, &ctx->sim, 0.1f, ALPHA, GAMMA, &ctx->rng, NULL);
+    }
+    return acc;
+}
+
+// Passos de treino gravando cada episódio (como a janela faz com o bot)
+static unsigned BenchTrainStepRecorded(void *p, long ops) {
+    EpisodeCtx *ctx = (EpisodeCtx *)p;
+    unsigned acc = 0;
+    actionlog_begin(&ctx->log, &ctx->sim);
+    for (long i = 0; i < ops; i++) {
+        if (ctx->sim.gameOver) {
+            actionlog_begin(&ctx->log, &ctx->sim);
+            sim_reset(&ctx->sim);
+        }
+        acc += train_step(ctx->Q, &ctx->sim, 0.1f, ALPHA, GAMMA, &ctx->rng, NULL);
+    }
+    ctx->sim.log = NULL;
+    return acc;
+}
+
+// Passos de treino com traços de elegibilidade (regra em ctx->params.learner)
+static unsigned BenchTraceStep(void *p, long ops) {
+    EpisodeCtx *ctx = (EpisodeCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        if (ctx->sim.gameOver) {
+            sim_reset(&ctx->sim);
+            train_trace_agent_reset(&ctx->traces);
+        }
+        acc += train_step_lambda(ctx->Q, &ctx->sim, 0.1f, &ctx->params, &ctx->traces, &ctx->rng, NULL);
+    }
+    return acc;
+}
+
+// Passos de treino do agente linear
+static unsigned BenchLinearStep(void *p, long ops) {
+    EpisodeCtx *ctx = (EpisodeCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        if (ctx->sim.gameOver) sim_reset(&ctx->sim);
+        acc += train_step_linear(ctx->linear, &ctx->sim, 0.1f, ALPHA, GAMMA, &ctx->rng, NULL);
+    }
+    return acc;
+}
+
+typedef struct {
+    TrainBatch tb;
+    QTable *Q;
+} BatchCtx;
+
+// Cada operação é um passo de lote: BENCH_BATCH jogos avançam juntos
+static unsigned BenchBatchStep(void *p, long ops) {
+    BatchCtx *ctx = (BatchCtx *)p;
+    unsigned acc = 0;
+    for (long i = 0; i < ops; i++) {
+        acc += (unsigned)train_batch_step(ctx->Q, &ctx->tb, 0.1f, ALPHA, GAMMA, 20000);
+    }
+    return acc;
+}
+
+// Episódios completos de treino; mede passos/s em vez de ns/op
+static BenchResult BenchEpisodes(EpisodeCtx *ctx, long episodes) {
+    BenchResult r = { "train_episode", 0.0, 0, -1, -1 };
+    double best = -1.0;
+    for (int k = 0; k < BENCH_REPEATS; k++) {
+        long count0 = __atomic_load_n(&allocCount, __ATOMIC_RELAXED);
+        long bytes0 = __atomic_load_n(&allocBytes, __ATOMIC_RELAXED);
+        long steps = 0;
+        double t0 = NowSeconds();
+        for (long e = 0; e < episodes; e++) {
+            TrainEpisodeStats es;
+            benchSink += (unsigned)train_episode(ctx->Q, &ctx->sim, &ctx->params, 0.1f, 20000, &es, &ctx->rng, NULL, NULL);
+            steps += es.steps;
+        }
+        double t = NowSeconds() - t0;
+        if (steps > 0 && (best < 0.0 || t / steps < best)) {
+            best = t / steps;
+            r.ops = steps;
+        }
+#ifdef BENCH_WRAP_MALLOC
+        r.allocs = __atomic_load_n(&allocCount, __ATOMIC_RELAXED) - count0;
+        r.allocBytes = __atomic_load_n(&allocBytes, __ATOMIC_RELAXED) - bytes0;
+#else
+        (void)count0;
+        (void)bytes0;
+#endif
+    }
+    r.nsPerOp = best * 1e9;
+    fprintf(stderr, "%-28s %10.2f ns/passo\n", r.name, r.nsPerOp);
+    return r;
+}
+
+static void PrintJsonLong(FILE *out, const char *key, long v) {
+    if (v < 0) fprintf(out, "\"%s\": null", key);
+    else fprintf(out, "\"%s\": %ld", key, v);
+}
+
+static void PrintJson(FILE *out, const BenchResult *results, int count, double seconds) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"schema\": 1,\n");
+#ifdef __VERSION__
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(out, "  \"bricks\": %d,\n", ROWS * COLS);
+    fprintf(out, "  \"states\": %d,\n", state_spec_default()->nStates);
+    fprintf(out, "  \"actions\": %d,\n", N_ACTIONS);
+    fprintf(out, "  \"seconds\": %.3f,\n", seconds);
+    fprintf(out, "  \"results\": [\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        double perSec = r->nsPerOp > 0.0 ? 1e9 / r->nsPerOp : 0.0;
+        fprintf(out, "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f, \"ops\": %ld, ",
+                r->name, r->nsPerOp, perSec, r->ops);
+        PrintJsonLong(out, "allocs", r->allocs);
+        fprintf(out, ", ");
+        PrintJsonLong(out, "alloc_bytes", r->allocBytes);
+        fprintf(out, " }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void PrintUsage(const char *prog) {
+    printf("Uso: %s [opções]\n", prog);
+    printf("  --quick         repetições curtas (para CI)\n");
+    printf("  --time S        segundos por repetição (padrão 0.2)\n");
+    printf("  --out ARQ       grava o JSON em ARQ (padrão: saída padrão)\n");
+}
+
+int main(int argc, char **argv) {
+    const char *outPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) benchMinTime = 0.02;
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) benchMinTime = atof(argv[++i]);
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else {
+            PrintUsage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+    if (benchMinTime <= 0.0) benchMinTime = 0.2;
+
+    const uint64_t seed = 12345;
+    BenchResult results[40];
+    int count = 0;
+    double start = NowSeconds();
+
+    AgentCtx *agent = (AgentCtx *)calloc(1, sizeof(AgentCtx));
+    BrickCtx *bricks = (BrickCtx *)calloc(1, sizeof(BrickCtx));
+    EpisodeCtx *episode = (EpisodeCtx *)calloc(1, sizeof(EpisodeCtx));
+    BatchCtx *batch = (BatchCtx *)calloc(1, sizeof(BatchCtx));
+    ReplayCtx *replay = (ReplayCtx *)calloc(1, sizeof(ReplayCtx));
+    QTable *Q = init_q_table(NULL);
+    if (!agent || !bricks || !episode || !batch || !replay || !Q) {
+        fprintf(stderr, "Falha ao alocar os benchmarks\n");
+        return 1;
+    }
+
+    agent->Q = Q;
+    InitAgentCtx(agent, seed);
+    results[count++] = RunBench("encode_state", BenchEncodeState, agent);
+    results[count++] = RunBench("encode_state_dispatch", BenchEncodeDispatch, agent);
+    results[count++] = RunBench("encode_state_divide", BenchEncodeDivide, agent);
+    results[count++] = RunBench("encode_state_coarse", BenchEncodeCoarse, agent);
+    results[count++] = RunBench("encode_state_near_paddle", BenchEncodeNearPaddle, agent);
+    results[count++] = RunBench("choose_action", BenchChooseAction, agent);
+    results[count++] = RunBench("greedy_action", BenchGreedyAction, agent);
+    if (policy_compile(&agent->policy, agent->Q, false)) {
+        results[count++] = RunBench("policy_action", BenchPolicyAction, agent);
+        policy_free(&agent->policy);
+    }
+    results[count++] = RunBench("q_learning_update", BenchQUpdate, agent);
+
+    LinearCtx *linear = NULL;
+    if (posix_memalign((void **)&linear, 32, sizeof(LinearCtx)) == 0) {
+        linear->agent = agent;
+        linear_init(&linear->L);
+        for (int k = 0; k < BENCH_SAMPLES; k++) linear_features(agent->paddle[k], agent->ball[k], linear->phi[k]);
+        results[count++] = RunBench("linear_features", BenchLinearFeatures, linear);
+        static const struct { const char *values, *update; int isa; } isas[] = {
+            { "linear_values_avx2", "linear_update_avx2", LINEAR_ISA_AVX2 },
+            { "linear_values_scalar", "linear_update_scalar", LINEAR_ISA_SCALAR },
+        };
+        for (int k = 0; k < 2; k++) {
+            if (linear_set_isa(isas[k].isa) != isas[k].isa) continue;   // CPU sem AVX2
+            results[count++] = RunBench(isas[k].values, BenchLinearValues, linear);
+            results[count++] = RunBench(isas[k].update, BenchLinearUpdate, linear);
+        }
+        linear_set_isa(LINEAR_ISA_AVX2);
+        free(linear);
+    }
+
+    // Mesmas operações na Q-table esparsa, com todos os estados presentes
+    QTable *hashed = init_q_table_hashed(Q->spec, Q->nStates, Q);
+    if (hashed) {
+        agent->Q = hashed;
+        results[count++] = RunBench("choose_action_hashed", BenchChooseAction, agent);
+        results[count++] = RunBench("q_learning_update_hashed", BenchQUpdate, agent);
+        agent->Q = Q;
+        free_q_table(hashed);
+    }
+
+    replay->agent = agent;
+    static const struct { const char *name; float priority; } replays[] = {
+        { "replay_batch32_uniform", 0.0f },
+        { "replay_batch32_prioritized", 0.6f },
+    };
+    for (int k = 0; k < 2; k++) {
+        if (!replay_init(&replay->rb, BENCH_REPLAY_CAPACITY, replays[k].priority, 0.4f)) break;
+        BenchResult push = RunBench("replay_push", BenchReplayPush, replay);
+        if (k == 0) results[count++] = push;
+        BenchResult r = RunBench(replays[k].name, BenchReplayUpdate, replay);
+        // Normaliza para ns por transição aplicada
+        r.nsPerOp /= BENCH_REPLAY_BATCH;
+        r.ops *= BENCH_REPLAY_BATCH;
+        results[count++] = r;
+        replay_free(&replay->rb);
+    }
+
+    static const struct { const char *name; int keep; } fields[] = {
+        { "create_bricks_full", 1 },
+        { "create_bricks_half", 2 },
+        { "create_bricks_near_empty", 3 },
+    };
+    for (int f = 0; f < 3; f++) {
+        InitBrickCtx(bricks, fields[f].keep, seed);
+        results[count++] = RunBench(fields[f].name, BenchCreateBricks, bricks);
+    }
+
+    sim_init(&episode->sim, SIM_DT, rng_env_seed(seed, 0));
+    rng_seed(&episode->rng, rng_agent_seed(seed, 0));
+    episode->Q = Q;
+    episode->params = (TrainParams)TRAIN_PARAMS_DEFAULT;
+    results[count++] = RunBench("sim_step", BenchSimStep, episode);
+    episode->sim.collision = SIM_COLLISION_SWEPT;
+    results[count++] = RunBench("sim_step_swept", BenchSimStep, episode);
+    episode->sim.collision = SIM_COLLISION_DISCRETE;
+    results[count++] = RunBench("train_step", BenchTrainStep, episode);
+    results[count++] = RunBench("train_step_recorded", BenchTrainStepRecorded, episode);
+    actionlog_free(&episode->log);
+    results[count++] = BenchEpisodes(episode, benchMinTime >= 0.2 ? 200 : 20);
+    if (posix_memalign((void **)&episode->linear, 32, sizeof(LinearQ)) == 0) {
+        linear_init(episode->linear);
+        results[count++] = RunBench("train_step_linear", BenchLinearStep, episode);
+        free(episode->linear);
+        episode->linear = NULL;
+    }
+    if (train_trace_agent_init(&episode->traces)) {
+        episode->params.learner = LEARNER_Q_LAMBDA;
+        results[count++] = RunBench("train_step_qlambda", BenchTraceStep, episode);
+        episode->params.learner = LEARNER_SARSA_LAMBDA;
+        results[count++] = RunBench("train_step_sarsa_lambda", BenchTraceStep, episode);
+        episode->params.learner = LEARNER_Q;
+        train_trace_agent_free(&episode->traces);
+    }
+
+    batch->Q = Q;
+    if (train_batch_init(&batch->tb, BENCH_BATCH, SIM_DT, seed, NULL, Q->spec)) {
+        BenchResult r = RunBench("train_batch_step_256", BenchBatchStep, batch);
+        // Normaliza para ns por passo de jogo, comparável com train_step
+        r.nsPerOp /= BENCH_BATCH;
+        r.ops *= BENCH_BATCH;
+        results[count++] = r;
+        train_batch_free(&batch->tb);
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Falha ao abrir %s\n", outPath);
+        return 1;
+    }
+    PrintJson(out, results, count, NowSeconds() - start);
+    if (out != stdout) fclose(out);
+
+    free_q_table(Q);
+    free(agent);
+    free(bricks);
+    free(episode);
+    free(batch);
+    free(replay);
+    return 0;
+}
@@ -1,7 +1,90 @@
+#define _POSIX_C_SOURCE 200112L
+
 #include "bot.h"
 #include "defs.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <sys/mman.h>
+
+#if defined(__SSE2__) && Q_STRIDE == 4
+#include <emmintrin.h>
+#define Q_ROW_SIMD 1
+#endif
+
+/*
+ * Acesso às entradas da Q-table com atomicidade relaxada: várias threads de
+ * treino podem ler e escrever a mesma tabela sem locks (estilo Hogwild!).
+ * Atualizações concorrentes podem se perder, mas nenhuma leitura vê um float
+ * "rasgado". Em x86/ARM isso compila para loads/stores comuns.
+ */
+static inline float QLoad(const float *p) {
+    float v;
+    __atomic_load(p, &v, __ATOMIC_RELAXED);
+    return v;
+}
+
+static inline void QStore(float *p, float v) {
+    __atomic_store(p, &v, __ATOMIC_RELAXED);
+}
+
+/*
+ * Maior valor e posição do maior valor de uma linha da Q-table. Com SSE a
+ * linha inteira vem em uma carga alinhada de 16 bytes (cada float dela é lido
+ * atomicamente) e o máximo sai de duas trocas de lanes; o preenchimento com
+ * -INFINITY garante que as posições extras nunca vencem.
+ */
+static inline float RowMax(const float *row) {
+#ifdef Q_ROW_SIMD
+    __m128 v = _mm_load_ps(row);
+    __m128 m = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(m);
+#else
+    float best = QLoad(&row[0]);
+    for (int a = 1; a < N_ACTIONS; a++) {
+        float q = QLoad(&row[a]);
+        if (q > best) best = q;
+    }
+    return best;
+#endif
+}
+
+static inline int RowArgmax(const float *row) {
+#ifdef Q_ROW_SIMD
+    __m128 v = _mm_load_ps(row);
+    __m128 m = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    // Primeira lane igual ao máximo: mesmo desempate de argmax()
+    return __builtin_ctz((unsigned)_mm_movemask_ps(_mm_cmpeq_ps(v, m)));
+#else
+    float values[N_ACTIONS];
+    for (int a = 0; a < N_ACTIONS; a++) values[a] = QLoad(&row[a]);
+    return argmax(values, N_ACTIONS);
+#endif
+}
+
+/*
+ * Linhas para leitura e escrita, nos dois armazenamentos. Na tabela esparsa
+ * um estado ausente lê a linha vazia; a escrita o insere e devolve NULL se
+ * não há mais espaço (a atualização é descartada).
+ */
+static inline const float *ReadRow(const QTable *Q, int state) {
+    if (!Q->hash) return q_row(Q, state);
+    return qhash_row(Q->hash, state);
+}
+
+static inline float *WriteRow(QTable *Q, int state) {
+    if (!Q->hash) return q_row(Q, state);
+    return qhash_insert(Q->hash, state);
+}
+
+// Linha de uma tabela nova: zeros nas ações, -INFINITY no preenchimento
+static void InitRow(float *row) {
+    for (int a = 0; a < Q_STRIDE; a++) {
+        row[a] = (a < N_ACTIONS) ? 0.0f : -INFINITY;
+    }
+}
 
 /**
  * Discretiza um valor contínuo em um índice de bin.
@@ -32,33 +115,89 @@ int sign_bin(float v) {
 }
 
 /**
- * Codifica o estado do ambiente (paddle e bola) em um único índice de estado discreto.
+ * Inicializa a tabela Q (Q-table) com zeros.
+ * Todas as linhas ficam em um único bloco alinhado a 64 bytes.
  * 
- * @param paddle Estrutura Rectangle representando o paddle.
- * @param ball Estrutura Ball representando a bola.
- * @return Índice do estado discreto.
+ * @param spec Discretização do estado (NULL = state_spec_default()).
+ * @return Ponteiro para a tabela Q alocada dinamicamente, ou NULL.
  */
-int encode_state(Rectangle paddle, Ball ball) {
-    int px = discretize(paddle.x, 0, SCREEN_W - PADDLE_W, N_PADDLE_X);
-    int bx = discretize(ball.pos.x, 0, SCREEN_W, N_BALL_X);
-    int by = discretize(ball.pos.y, 0, SCREEN_H, N_BALL_Y);
-    int bvx = sign_bin(ball.vel.x);
-    int bvy = sign_bin(ball.vel.y);
-    // Combina todos os índices discretizados em um único índice de estado
-    return (((((px * N_BALL_X + bx) * N_BALL_Y + by) * N_BALL_VX + bvx) * N_BALL_VY) + bvy);
+QTable *init_q_table(const StateSpec *spec) {
+    if (!spec) spec = state_spec_default();
+    QTable *Q = (QTable*)malloc(sizeof(QTable));
+    if (!Q) return NULL;
+
+    size_t count = (size_t)spec->nStates * Q_STRIDE;
+    if (posix_memalign((void**)&Q->data, 64, count * sizeof(float)) != 0) {
+        free(Q);
+        return NULL;
+    }
+    Q->nStates = spec->nStates;
+    Q->spec = spec;
+    Q->mapBase = NULL;
+    Q->mapSize = 0;
+    Q->hash = NULL;
+
+    for (int s = 0; s < Q->nStates; s++) InitRow(q_row(Q, s));
+    return Q;
+}
+
+QTable *init_q_table_hashed(const StateSpec *spec, long states, const QTable *from) {
+    if (!spec) spec = from ? from->spec : state_spec_default();
+    if (from && from->spec != spec) return NULL;
+    QTable *Q = (QTable*)calloc(1, sizeof(QTable));
+    QHash *hash = (QHash*)malloc(sizeof(QHash));
+    float empty[Q_STRIDE];
+    InitRow(empty);
+    if (!Q || !hash || !qhash_init(hash, states, Q_STRIDE, empty)) {
+        free(hash);
+        free(Q);
+        return NULL;
+    }
+    Q->nStates = spec->nStates;
+    Q->spec = spec;
+    Q->hash = hash;
+
+    // Só as linhas já aprendidas (alguma ação diferente de zero) entram
+    for (int s = 0; from && s < from->nStates; s++) {
+        const float *src = ReadRow(from, s);
+        bool learned = false;
+        for (int a = 0; a < N_ACTIONS; a++) learned = learned || src[a] != 0.0f;
+        if (!learned) continue;
+        float *row = WriteRow(Q, s);
+        if (!row) {
+            free_q_table(Q);
+            return NULL;
+        }
+        memcpy(row, src, Q_STRIDE * sizeof(float));
+    }
+    return Q;
+}
+
+void q_export_dense(const QTable *Q, float *dst) {
+    if (!Q->hash) {
+        memcpy(dst, Q->data, (size_t)Q->nStates * Q_STRIDE * sizeof(float));
+        return;
+    }
+    for (int s = 0; s < Q->nStates; s++) {
+        const float *row = ReadRow(Q, s);
+        for (int a = 0; a < Q_STRIDE; a++) dst[(size_t)s * Q_STRIDE + a] = QLoad(&row[a]);
+    }
 }
 
 /**
- * Inicializa a tabela Q (Q-table) com zeros.
+ * Libera uma tabela criada por init_q_table ou map_qtable.
  * 
- * @return Ponteiro para a tabela Q alocada dinamicamente.
+ * @param Q Tabela Q (pode ser NULL).
  */
-float **init_q_table(void) {
-    float **Q = (float**)malloc(N_STATES * sizeof(float*));
-    for (int i = 0; i < N_STATES; i++) {
-        Q[i] = (float*)calloc(N_ACTIONS, sizeof(float));
+void free_q_table(QTable *Q) {
+    if (!Q) return;
+    if (Q->mapBase) munmap(Q->mapBase, Q->mapSize);
+    else free(Q->data);
+    if (Q->hash) {
+        qhash_free(Q->hash);
+        free(Q->hash);
     }
-    return Q;
+    free(Q);
 }
 
 /**
@@ -71,18 +210,39 @@ float **init_q_table(void) {
  * @param next_state Próximo estado.
  * @param alpha Taxa de aprendizado.
  * @param gamma Fator de desconto.
- * @param num_actions Número de ações possíveis.
+ * @return Erro TD (alvo - Q(s,a) antes da atualização).
  */
-void q_learning_update(float **Q, int state, int action, float reward, int next_state, float alpha, float gamma, int num_actions) {
+float q_td_update(QTable *Q, int state, int action, float reward, int next_state, float alpha, float gamma) {
     // Encontra o maior valor Q para o próximo estado (política gulosa)
-    float max_q_next = Q[next_state][0];
-    for (int a = 1; a < num_actions; a++) {
-        if (Q[next_state][a] > max_q_next) {
-            max_q_next = Q[next_state][a];
-        }
-    }
+    float max_q_next = RowMax(ReadRow(Q, next_state));
+
     // Atualiza o valor Q para o par (estado, ação) atual
-    Q[state][action] = Q[state][action] + alpha * (reward + gamma * max_q_next - Q[state][action]);
+    float *row = WriteRow(Q, state);
+    if (!row) return reward + gamma * max_q_next - QLoad(&ReadRow(Q, state)[action]);
+    float *q = row + action;
+    float old = QLoad(q);
+    float td = reward + gamma * max_q_next - old;
+    QStore(q, old + alpha * td);
+    return td;
+}
+
+void q_learning_update(QTable *Q, int state, int action, float reward, int next_state, float alpha, float gamma, int num_actions) {
+    (void)num_actions;  // a largura da linha é fixa (Q_STRIDE), com padding -INFINITY
+    q_td_update(Q, state, action, reward, next_state, alpha, gamma);
+}
+
+float q_value(const QTable *Q, int state, int action) {
+    return QLoad(ReadRow(Q, state) + action);
+}
+
+void q_add(QTable *Q, int state, int action, float delta) {
+    float *row = WriteRow(Q, state);
+    if (!row) return;
+    QStore(row + action, QLoad(row + action) + delta);
+}
+
+int greedy_action(const QTable *Q, int state) {
+    return RowArgmax(ReadRow(Q, state));
 }
 
 #include "bot.h"
@@ -115,20 +275,21 @@ int argmax(const float *arr, int len) {
  * (exploração). Caso contrário, escolhe a ação que maximiza
  * a estimativa de recompensa futura no estado atual (exploração greedy).
  *
- * @param Q        Tabela Q, matriz de dimensões [N_STATES][N_ACTIONS],
+ * @param Q        Tabela Q com Q->nStates linhas de N_ACTIONS valores,
  *                 contendo os valores de Q(s,a) para cada par estado‑ação.
- * @param state    Índice do estado atual (0 ≤ state < N_STATES).
+ * @param state    Índice do estado atual (0 ≤ state < Q->nStates).
  * @param epsilon  Probabilidade de explorar (0.0 ≤ epsilon ≤ 1.0).
+ * @param rng      Gerador do agente (um por thread/agente).
  * @return         Índice da ação selecionada (0 ≤ ação < N_ACTIONS).
  */
-int choose_action(float **Q, int state, float epsilon) {
-    float r = (float)rand() / (float)RAND_MAX;
+int choose_action(const QTable *Q, int state, float epsilon, Rng *rng) {
+    float r = rng_float(rng);
     if (r < epsilon) {
         /* Exploração: escolhe ação aleatória */
-        return rand() % N_ACTIONS;
+        return rng_range(rng, 0, N_ACTIONS - 1);
     } else {
         /* Exploração greedy: escolhe ação de maior valor Q */
-        return argmax(Q[state], N_ACTIONS);
+        return RowArgmax(ReadRow(Q, state));
     }
 }
 
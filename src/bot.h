@@ -1,29 +1,45 @@
 #ifndef BOT_H
 #define BOT_H
 
-#include "raylib.h"
 #include "defs.h"
-
-// Quantidade de segmentos para a posição do paddle no eixo X
-#define N_PADDLE_X   12   
-
-// Quantidade de segmentos para a posição da bola no eixo X
-#define N_BALL_X     12   
-
-// Quantidade de segmentos para a posição da bola no eixo Y
-#define N_BALL_Y     16   
-
-// Quantidade de bins para a velocidade da bola no eixo X (-1, 0, +1)
-#define N_BALL_VX     3   
-
-// Quantidade de bins para a velocidade da bola no eixo Y (-1, 0, +1)
-#define N_BALL_VY     3   
+#include "rng.h"
+#include "statespec.h"
+#include "qhash.h"
+#include <stddef.h>
 
 // Quantidade de ações possíveis: Esquerda, Parado, Direita
 #define N_ACTIONS     3   
 
-// Número total de estados possíveis (produto cartesiano dos bins)
-#define N_STATES (N_PADDLE_X * N_BALL_X * N_BALL_Y * N_BALL_VX * N_BALL_VY)
+// Floats por linha da Q-table: N_ACTIONS arredondado para 4, de modo que uma
+// linha inteira cabe em uma carga SIMD de 16 bytes. As posições extras guardam
+// -INFINITY e nunca vencem um argmax.
+#define Q_STRIDE ((N_ACTIONS + 3) & ~3)
+
+/*
+ * Q-table em um único bloco contíguo, alinhado a uma linha de cache:
+ * a linha do estado s começa em data + s * Q_STRIDE. Com hash != NULL as
+ * linhas ficam em uma tabela esparsa (só estados visitados) e data é NULL;
+ * as funções abaixo escondem a diferença. spec é a discretização com que as
+ * linhas foram aprendidas; nStates é spec->nStates.
+ */
+typedef struct {
+    float *data;    // nStates * Q_STRIDE floats (NULL na tabela esparsa)
+    int nStates;    // número de linhas (estados)
+    const StateSpec *spec; // discretização do estado
+    void *mapBase;  // início do mapeamento, se a tabela veio de map_qtable
+    size_t mapSize; // tamanho do mapeamento em bytes
+    QHash *hash;    // armazenamento esparso (NULL = denso)
+} QTable;
+
+/**
+ * Linha de valores Q de um estado (só tabela densa).
+ * @param Q Tabela Q.
+ * @param state Índice do estado.
+ * @return Ponteiro para os Q_STRIDE floats do estado (alinhado a 16 bytes).
+ */
+static inline float *q_row(const QTable *Q, int state) {
+    return Q->data + (size_t)state * Q_STRIDE;
+}
 
 /**
  * Discretiza um valor contínuo em um índice de bin.
@@ -43,21 +59,51 @@ int discretize(float value, float min, float max, int bins);
 int sign_bin(float v);
 
 /**
- * Codifica o estado do ambiente (paddle e bola) em um único índice de estado discreto.
- * @param paddle Estrutura Rectangle representando o paddle.
- * @param ball Estrutura Ball representando a bola.
- * @return Índice do estado discreto.
+ * Codifica o estado do ambiente (paddle e bola) em um único índice de estado
+ * discreto, segundo a discretização da tabela.
+ * @param Q Tabela Q.
+ * @param paddle Paddle.
+ * @param ball Bola.
+ * @return Índice do estado, em [0, Q->nStates).
+ */
+static inline int q_encode(const QTable *Q, Rectangle paddle, Ball ball) {
+    return Q->spec->encode(paddle, ball);
+}
+
+/**
+ * Inicializa a tabela Q (Q-table) com zeros, em um único bloco alinhado.
+ * @param spec Discretização do estado (NULL = state_spec_default()).
+ * @return Ponteiro para a tabela Q alocada dinamicamente, ou NULL.
  */
-int encode_state(Rectangle paddle, Ball ball);
+QTable *init_q_table(const StateSpec *spec);
 
 /**
- * Inicializa a tabela Q (Q-table) com zeros.
- * @return Ponteiro para a tabela Q alocada dinamicamente.
+ * Cria uma Q-table esparsa: só os estados visitados ocupam memória.
+ * @param spec Discretização do estado (NULL = a de from, ou a padrão).
+ * @param states Estados distintos que devem caber (além disso, estados novos
+ *               leem como zero e não são aprendidos).
+ * @param from Tabela densa cujas linhas não nulas são copiadas (pode ser NULL).
+ * @return Q-table esparsa, ou NULL se a alocação falhar, from não couber ou
+ *         tiver outra discretização.
  */
-float **init_q_table(void);
+QTable *init_q_table_hashed(const StateSpec *spec, long states, const QTable *from);
+
+/**
+ * Copia todas as linhas para um vetor denso (estados ausentes saem zerados).
+ * @param Q Tabela Q (densa ou esparsa).
+ * @param dst Destino com Q->nStates * Q_STRIDE floats.
+ */
+void q_export_dense(const QTable *Q, float *dst);
+
+/**
+ * Libera uma tabela criada por init_q_table ou map_qtable.
+ * @param Q Tabela Q (pode ser NULL).
+ */
+void free_q_table(QTable *Q);
 
 /**
  * Atualiza a tabela Q usando a regra do Q-Learning.
+ * Pode ser chamada por várias threads sobre a mesma tabela (sem locks).
  * @param Q Tabela Q.
  * @param state Estado atual.
  * @param action Ação tomada.
@@ -67,7 +113,40 @@ float **init_q_table(void);
  * @param gamma Fator de desconto.
  * @param num_actions Número de ações possíveis.
  */
-void q_learning_update(float **Q, int state, int action, float reward, int next_state, float alpha, float gamma, int num_actions);
+void q_learning_update(QTable *Q, int state, int action, float reward, int next_state, float alpha, float gamma, int num_actions);
+
+/**
+ * Mesma atualização de q_learning_update, devolvendo o erro TD usado
+ * (alvo - Q(s,a) antes da atualização). Usado para priorizar amostras.
+ * @return Erro TD da transição.
+ */
+float q_td_update(QTable *Q, int state, int action, float reward, int next_state, float alpha, float gamma);
+
+/**
+ * Lê Q(s,a) com a mesma atomicidade relaxada das atualizações.
+ * @param Q Tabela Q.
+ * @param state Estado.
+ * @param action Ação.
+ * @return Valor atual de Q(s,a).
+ */
+float q_value(const QTable *Q, int state, int action);
+
+/**
+ * Soma delta a Q(s,a) (leitura e escrita relaxadas, sem lock).
+ * @param Q Tabela Q.
+ * @param state Estado.
+ * @param action Ação.
+ * @param delta Incremento.
+ */
+void q_add(QTable *Q, int state, int action, float delta);
+
+/**
+ * Ação gulosa do estado (primeira de maior valor, como argmax).
+ * @param Q Tabela Q.
+ * @param state Estado.
+ * @return Índice da ação.
+ */
+int greedy_action(const QTable *Q, int state);
 
 /**
  * @brief Encontra o índice do maior valor em um vetor de floats.
@@ -89,12 +168,13 @@ int argmax(const float *arr, int len);
  * (exploração). Caso contrário, escolhe a ação que maximiza
  * a estimativa de recompensa futura no estado atual (exploração greedy).
  *
- * @param Q        Tabela Q, matriz de dimensões [N_STATES][N_ACTIONS],
+ * @param Q        Tabela Q com Q->nStates linhas de N_ACTIONS valores,
  *                 contendo os valores de Q(s,a) para cada par estado‑ação.
- * @param state    Índice do estado atual (0 ≤ state < N_STATES).
+ * @param state    Índice do estado atual (0 ≤ state < Q->nStates).
  * @param epsilon  Probabilidade de explorar (0.0 ≤ epsilon ≤ 1.0).
+ * @param rng      Gerador do agente (um por thread/agente).
  * @return         Índice da ação selecionada (0 ≤ ação < N_ACTIONS).
  */
-int choose_action(float **Q, int state, float epsilon);
+int choose_action(const QTable *Q, int state, float epsilon, Rng *rng);
 
 #endif // BOT_H
@@ -1,40 +1,81 @@
 #include "defs.h"
-#include "sound.h"
+#include "brick.h"
+#include "sim.h"
 
 #include <math.h>
 
-void InitBricks(Brick bricks[ROWS][COLS]) {
-    const int offsetX = (SCREEN_W - (COLS * (BRICK_WIDTH + BRICK_SP) - BRICK_SP)) / 2;
-    const int offsetY = 60;
-
-    for (int r = 0; r < ROWS; ++r)
-    for (int c = 0; c < COLS; ++c) {
-        bricks[r][c].rect = (Rectangle){
-            offsetX + c * (BRICK_WIDTH + BRICK_SP),
-            offsetY + r * (BRICK_HEIGHT + BRICK_SP),
-            BRICK_WIDTH, BRICK_HEIGHT };
-        bricks[r][c].alive = true;
-        bricks[r][c].color = ColorFromHSV(r * 36.0f, 0.7f, 0.9f);
+// Folga (px) nas bordas da caixa da bola ao converter para células: cobre
+// arredondamentos, o teste exato decide
+#define GRID_MARGIN 1.0f
+
+// Intervalo [*lo, *hi] de células (de tamanho pitch, a partir de offset) que
+// cruzam [a, b]; false se nenhuma
+static bool CellRange(float a, float b, float offset, float pitch, int count, int *lo, int *hi) {
+    float first = (a - GRID_MARGIN - offset) * (1.0f / pitch);
+    float last  = (b + GRID_MARGIN - offset) * (1.0f / pitch);
+    if (last < 0.0f || first >= (float)count) return false;
+    *lo = first < 0.0f ? 0 : (int)first;
+    *hi = (int)last >= count ? count - 1 : (int)last;
+    return true;
+}
+
+// Bits da palavra w do bitset de uma fileira que caem nas colunas [c0, c1]
+static inline uint64_t ColumnMask(int c0, int c1, int w) {
+    int lo = c0 - (w << 6), hi = c1 - (w << 6);
+    if (lo < 0) lo = 0;
+    if (hi > 63) hi = 63;
+    return ((~0ull) >> (63 - hi)) & ~((1ull << lo) - 1);
+}
+
+bool HitBrickBits(const Level *level, uint64_t *alive, uint64_t *const *hits, int r, int c) {
+    int w = r * level->words + (c >> 6);
+    uint64_t bit = 1ull << (c & 63);
+    if (level->multiHit) {
+        // Contador de acertos em LEVEL_HP_BITS planos de bits
+        int hp = LEVEL_CELL_HP(level->cells[r * level->cols + c]);
+        int count = 0;
+        for (int p = 0; p < LEVEL_HP_BITS; p++) count |= ((hits[p][w] & bit) != 0) << p;
+        if (++count < hp) {
+            for (int p = 0; p < LEVEL_HP_BITS; p++)
+                hits[p][w] = ((count >> p) & 1) ? hits[p][w] | bit : hits[p][w] & ~bit;
+            return false;
+        }
     }
+    alive[w] &= ~bit;
+    return true;
+}
+
+bool HitBrick(const Level *level, BrickField *field, int r, int c) {
+    uint64_t *hits[LEVEL_HP_BITS];
+    for (int p = 0; p < LEVEL_HP_BITS; p++) hits[p] = field->hits[p];
+    return HitBrickBits(level, field->alive, hits, r, c);
 }
 
-void CreateBricks(Brick bricks[ROWS][COLS], Ball *ball, int *score) {
+bool CollideBrickBits(const Level *level, uint64_t *alive, uint64_t *const *hits, Ball *ball, int *score) {
+    // Células da grade que a caixa da bola pode tocar
+    int r0, r1, c0, c1;
+    if (!CellRange(ball->pos.y - ball->radius, ball->pos.y + ball->radius,
+                   level->offsetY, level->pitchY, level->rows, &r0, &r1)) return false;
+    if (!CellRange(ball->pos.x - ball->radius, ball->pos.x + ball->radius,
+                   level->offsetX, level->pitchX, level->cols, &c0, &c1)) return false;
+
     // tijolos
-    for (int r = 0; r < ROWS; ++r)
-        for (int c = 0; c < COLS; ++c) {
-            Brick *b = &bricks[r][c];
-            if (!b->alive) continue;
+    for (int r = r0; r <= r1; ++r)
+    for (int w = c0 >> 6; w <= c1 >> 6; ++w) {
+        uint64_t bits = alive[r * level->words + w] & ColumnMask(c0, c1, w);   // vazia nessas colunas: pula
+        while (bits) {
+            int c = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            Rectangle rect = level_brick_rect(level, r, c);
 
-            if (CheckCollisionCircleRec(ball->pos, ball->radius, b->rect)) {
-                PlaySound(brickHitSound);
-                b->alive = false;
-                *score += 10;
+            if (CheckCollisionBallRec(ball->pos, ball->radius, rect)) {
+                if (HitBrickBits(level, alive, hits, r, c)) *score += 10;
 
                 // Calcula as distâncias das bordas da bola em relação ao bloco
-                float dist_top    = fabsf((ball->pos.y + ball->radius) - b->rect.y);
-                float dist_bottom = fabsf((ball->pos.y - ball->radius) - (b->rect.y + b->rect.height));
-                float dist_left   = fabsf((ball->pos.x + ball->radius) - b->rect.x);
-                float dist_right  = fabsf((ball->pos.x - ball->radius) - (b->rect.x + b->rect.width));
+                float dist_top    = fabsf((ball->pos.y + ball->radius) - rect.y);
+                float dist_bottom = fabsf((ball->pos.y - ball->radius) - (rect.y + rect.height));
+                float dist_left   = fabsf((ball->pos.x + ball->radius) - rect.x);
+                float dist_right  = fabsf((ball->pos.x - ball->radius) - (rect.x + rect.width));
 
                 // Verifica se a colisão é mais próxima dos lados vertical ou horizontal
                 if (fminf(dist_top, dist_bottom) < fminf(dist_left, dist_right)) {
@@ -45,16 +86,49 @@ void CreateBricks(Brick bricks[ROWS][COLS], Ball *ball, int *score) {
                     ball->vel.x *= -1.0f;
                 }
 
-                goto skipRemaining; // evita multi-colisão no mesmo frame
+                return true; // evita multi-colisão no mesmo frame
             }
         }
-    skipRemaining: ;
+    }
+    return false;
 }
 
-void DrawBricks(Brick bricks[ROWS][COLS]) {
-    for (int r = 0; r < ROWS; ++r)
-    for (int c = 0; c < COLS; ++c)
-    if (bricks[r][c].alive)
-        DrawRectangleRec(bricks[r][c].rect, bricks[r][c].color);
+bool CreateBricks(const Level *level, BrickField *field, Ball *ball, int *score) {
+    uint64_t *hits[LEVEL_HP_BITS];
+    for (int p = 0; p < LEVEL_HP_BITS; p++) hits[p] = field->hits[p];
+    return CollideBrickBits(level, field->alive, hits, ball, score);
 }
 
+bool SweepBricks(const Level *level, const uint64_t *alive, Vector2 pos, Vector2 vel, float radius,
+                 float tMax, float *t, Vector2 *normal, int *row, int *col) {
+    // Células cobertas pela caixa do trajeto inteiro
+    float endX = pos.x + vel.x * tMax, endY = pos.y + vel.y * tMax;
+    int r0, r1, c0, c1;
+    if (!CellRange(fminf(pos.y, endY) - radius, fmaxf(pos.y, endY) + radius,
+                   level->offsetY, level->pitchY, level->rows, &r0, &r1)) return false;
+    if (!CellRange(fminf(pos.x, endX) - radius, fmaxf(pos.x, endX) + radius,
+                   level->offsetX, level->pitchX, level->cols, &c0, &c1)) return false;
+
+    bool found = false;
+    float best = tMax;
+    for (int r = r0; r <= r1; ++r)
+    for (int w = c0 >> 6; w <= c1 >> 6; ++w) {
+        uint64_t bits = alive[r * level->words + w] & ColumnMask(c0, c1, w);
+        while (bits) {
+            int c = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            float tHit;
+            Vector2 n;
+            if (SweepBallRec(pos, vel, radius, level_brick_rect(level, r, c), best, &tHit, &n)
+                && (!found || tHit < best)) {
+                found = true;
+                best = tHit;
+                *normal = n;
+                *row = r;
+                *col = c;
+            }
+        }
+    }
+    if (found) *t = best;
+    return found;
+}
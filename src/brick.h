@@ -2,11 +2,75 @@
 #define BRICK_H
 
 #include "defs.h"
+#include "level.h"
+#include <stdint.h>
 
-void InitBricks(Brick bricks[ROWS][COLS]);
+/**
+ * Testa a bola contra os tijolos vivos e resolve no máximo uma colisão.
+ * Só as células da grade cobertas pela caixa da bola são testadas, e
+ * palavras do bitset sem tijolos vivos nessas colunas são puladas: o custo
+ * não depende do tamanho do nível. O tijolo atingido é o mesmo da varredura
+ * completa (o primeiro em ordem de fileira e coluna).
+ * Não toca em áudio: quem chama decide se toca o som do impacto.
+ * @param level Nível (geometria e pontos de vida).
+ * @param field Tijolos do jogo, atualizados com o acerto.
+ * @param ball Bola; a velocidade é refletida se houver colisão.
+ * @param score Pontuação, somada em 10 por tijolo destruído.
+ * @return true se algum tijolo foi atingido neste passo.
+ */
+bool CreateBricks(const Level *level, BrickField *field, Ball *ball, int *score);
 
-void CreateBricks(Brick bricks[ROWS][COLS], Ball *ball, int *score);
+/**
+ * O mesmo teste de CreateBricks sobre bitsets avulsos (ex.: os do lote).
+ * @param level Nível.
+ * @param alive Tijolos vivos (level->rows * level->words palavras).
+ * @param hits LEVEL_HP_BITS planos de acertos do mesmo tamanho (só lidos se
+ *             level->multiHit).
+ * @param ball Bola; a velocidade é refletida se houver colisão.
+ * @param score Pontuação, somada em 10 por tijolo destruído.
+ * @return true se algum tijolo foi atingido neste passo.
+ */
+bool CollideBrickBits(const Level *level, uint64_t *alive, uint64_t *const *hits, Ball *ball, int *score);
 
-void DrawBricks(Brick bricks[ROWS][COLS]);
+/**
+ * Primeiro tijolo vivo atingido por uma bola em movimento retilíneo (modo de
+ * colisão contínua). Só as células cobertas pelo trajeto são testadas; em
+ * empate vale a ordem de fileira e coluna. Não altera o campo.
+ * @param level Nível.
+ * @param alive Bitset de tijolos vivos (BrickField.alive).
+ * @param pos Centro da bola no início do trajeto.
+ * @param vel Velocidade da bola.
+ * @param radius Raio da bola.
+ * @param tMax Duração do trajeto.
+ * @param t Saída: tempo do impacto.
+ * @param normal Saída: normal do tijolo no ponto de contato.
+ * @param row Saída: fileira do tijolo atingido.
+ * @param col Saída: coluna do tijolo atingido.
+ * @return true se algum tijolo é atingido até tMax.
+ */
+bool SweepBricks(const Level *level, const uint64_t *alive, Vector2 pos, Vector2 vel, float radius,
+                 float tMax, float *t, Vector2 *normal, int *row, int *col);
 
-#endif // BRICK_H
\ No newline at end of file
+/**
+ * Aplica um acerto ao tijolo (r, c): conta o acerto e, no último ponto de
+ * vida, apaga o tijolo do bitset.
+ * @param level Nível.
+ * @param field Tijolos do jogo.
+ * @param r Fileira.
+ * @param c Coluna.
+ * @return true se o tijolo foi destruído.
+ */
+bool HitBrick(const Level *level, BrickField *field, int r, int c);
+
+/**
+ * HitBrick sobre bitsets avulsos (mesmo layout de CollideBrickBits).
+ * @param level Nível.
+ * @param alive Tijolos vivos.
+ * @param hits Planos de acertos (só usados se level->multiHit).
+ * @param r Fileira.
+ * @param c Coluna.
+ * @return true se o tijolo foi destruído.
+ */
+bool HitBrickBits(const Level *level, uint64_t *alive, uint64_t *const *hits, int r, int c);
+
+#endif // BRICK_H
@@ -0,0 +1,85 @@
+#include "checkpoint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void *WriterMain(void *arg) {
+    Checkpointer *ck = (Checkpointer *)arg;
+
+    pthread_mutex_lock(&ck->lock);
+    for (;;) {
+        while (!ck->pending && !ck->quit) pthread_cond_wait(&ck->cond, &ck->lock);
+        if (!ck->pending) break;   // quit sem nada pendente
+
+        // O snapshot só é tocado por esta thread enquanto pending == true
+        QTableMeta meta = ck->meta;
+        pthread_mutex_unlock(&ck->lock);
+        bool ok = save_qtable_meta(ck->snapshot, &meta, ck->path);
+        pthread_mutex_lock(&ck->lock);
+
+        if (ok) ck->written++;
+        else {
+            ck->failed++;
+            fprintf(stderr, "Falha ao gravar checkpoint em %s\n", ck->path);
+        }
+        ck->pending = false;
+        pthread_cond_broadcast(&ck->cond);
+    }
+    pthread_mutex_unlock(&ck->lock);
+    return NULL;
+}
+
+bool checkpoint_start(Checkpointer *ck, const char *path, const StateSpec *spec) {
+    memset(ck, 0, sizeof(*ck));
+    ck->snapshot = init_q_table(spec);
+    ck->path = (char *)malloc(strlen(path) + 1);
+    if (!ck->snapshot || !ck->path) {
+        free_q_table(ck->snapshot);
+        free(ck->path);
+        return false;
+    }
+    strcpy(ck->path, path);
+
+    pthread_mutex_init(&ck->lock, NULL);
+    pthread_cond_init(&ck->cond, NULL);
+    if (pthread_create(&ck->thread, NULL, WriterMain, ck) != 0) {
+        pthread_mutex_destroy(&ck->lock);
+        pthread_cond_destroy(&ck->cond);
+        free_q_table(ck->snapshot);
+        free(ck->path);
+        return false;
+    }
+    return true;
+}
+
+bool checkpoint_submit(Checkpointer *ck, const QTable *Q, const QTableMeta *meta, bool wait) {
+    if (Q->spec != ck->snapshot->spec) return false;   // o snapshot tem outra discretização
+    pthread_mutex_lock(&ck->lock);
+    if (ck->pending && !wait) {
+        pthread_mutex_unlock(&ck->lock);
+        return false;
+    }
+    while (ck->pending) pthread_cond_wait(&ck->cond, &ck->lock);
+
+    q_export_dense(Q, ck->snapshot->data);
+    ck->meta = *meta;
+    ck->pending = true;
+    pthread_cond_broadcast(&ck->cond);
+    pthread_mutex_unlock(&ck->lock);
+    return true;
+}
+
+void checkpoint_stop(Checkpointer *ck) {
+    pthread_mutex_lock(&ck->lock);
+    ck->quit = true;
+    pthread_cond_broadcast(&ck->cond);
+    pthread_mutex_unlock(&ck->lock);
+    pthread_join(ck->thread, NULL);
+
+    pthread_mutex_destroy(&ck->lock);
+    pthread_cond_destroy(&ck->cond);
+    free_q_table(ck->snapshot);
+    free(ck->path);
+    ck->snapshot = NULL;
+    ck->path = NULL;
+}
@@ -0,0 +1,56 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "bot.h"
+#include "qtable_io.h"
+#include <pthread.h>
+#include <stdbool.h>
+
+/*
+ * Checkpoints assíncronos do treino. O loop de treino só copia a Q-table para
+ * um buffer reservado (memcpy de algumas centenas de KB) e sinaliza; a escrita
+ * em disco acontece em uma thread separada. Se a escrita anterior ainda não
+ * terminou, o pedido é descartado em vez de travar o treino.
+ */
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    QTable *snapshot;       // cópia que a thread de escrita grava
+    QTableMeta meta;        // metadados da cópia
+    char *path;             // arquivo de destino
+    bool pending;           // há uma cópia esperando para ser gravada
+    bool quit;              // pedido de encerramento
+    long written;           // checkpoints gravados com sucesso
+    long failed;            // checkpoints que falharam
+} Checkpointer;
+
+/**
+ * Cria o buffer de snapshot e inicia a thread de escrita.
+ * @param ck Checkpointer.
+ * @param path Arquivo de checkpoint (formato de save_qtable_meta).
+ * @param spec Discretização das tabelas que serão enviadas.
+ * @return true se tudo foi criado.
+ */
+bool checkpoint_start(Checkpointer *ck, const char *path, const StateSpec *spec);
+
+/**
+ * Copia a Q-table e os metadados para o snapshot e agenda a escrita.
+ * @param ck Checkpointer.
+ * @param Q Q-table atual.
+ * @param meta Estado do treino (epsilon, episódio, geradores...).
+ * @param wait Se true, espera a escrita anterior terminar; se false e a
+ *             thread estiver ocupada, desiste sem copiar.
+ * @return true se o snapshot foi agendado (false também se Q não tem a
+ *         discretização de checkpoint_start).
+ */
+bool checkpoint_submit(Checkpointer *ck, const QTable *Q, const QTableMeta *meta, bool wait);
+
+/**
+ * Grava o que estiver pendente, encerra a thread e libera os recursos.
+ * @param ck Checkpointer.
+ */
+void checkpoint_stop(Checkpointer *ck);
+
+#endif // CHECKPOINT_H
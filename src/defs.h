@@ -1,7 +1,11 @@
 #ifndef DEFS_H
 #define DEFS_H
 
+#ifdef ARKANOID_HEADLESS
+#include "rl_types.h"   // build sem janela/áudio: só os tipos básicos
+#else
 #include "raylib.h"
+#endif
 
 #define SCREEN_W   800
 #define SCREEN_H   600
@@ -27,11 +31,4 @@ typedef struct {
     float radius;
 } Ball;
 
-// Brick
-typedef struct {
-    Rectangle rect;
-    bool alive;
-    Color color;
-} Brick;
-
 #endif // DEFS_H 
\ No newline at end of file
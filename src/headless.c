@@ -0,0 +1,661 @@
+/********************************************************************
+ * Arkanoid — treino headless do bot Q-Learning
+ * Sem janela, áudio ou GPU: a simulação roda na velocidade da CPU.
+ ********************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "defs.h"
+#include "sim.h"
+#include "bot.h"
+#include "train.h"
+#include "trainer.h"
+#include "qtable_io.h"
+#include "checkpoint.h"
+#include "actionlog.h"
+#include "sweep.h"
+#include "telemetry.h"
+#include "policy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Arquivo de checkpoint usado por --resume quando --checkpoint não é dado
+#define DEFAULT_CHECKPOINT "arkanoid.ckpt"
+
+// Tabela de resultados de --sweep quando --sweep-out não é dado
+#define DEFAULT_SWEEP_OUT "sweep.csv"
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void PrintUsage(const char *prog) {
+    printf("Uso: %s [opções]\n", prog);
+    printf("  --episodes N    episódios de treino (padrão 1000)\n");
+    printf("  --max-steps N   limite de passos por episódio (padrão 20000, 0 = ilimitado)\n");
+    printf("  --dt S          passo fixo da simulação em segundos (padrão 1/60)\n");
+    printf("  --ccd           colisão contínua (sem atravessar tijolos com --dt grande)\n");
+    printf("  --seed N        semente do gerador aleatório\n");
+    printf("  --batch N       treina N jogos em lote (SoA) com a mesma Q-table\n");
+    printf("  --threads N     treina com N threads sobre a mesma Q-table (sem locks)\n");
+    printf("  --learner R     regra de aprendizado: q (padrão), qlambda, sarsa-lambda ou linear\n");
+    printf("  --lambda L      decaimento dos traços de elegibilidade (padrão %.2f)\n", LAMBDA);
+    printf("  --exp-replay N  aprende por buffer de experiência com N transições\n");
+    printf("  --exp-batch N   transições por minilote (padrão 32)\n");
+    printf("  --exp-every N   passos entre minilotes (padrão 4)\n");
+    printf("  --exp-priority A  amostragem priorizada pelo erro TD com expoente A (0 = uniforme)\n");
+    printf("  --exp-beta B    expoente dos pesos de importância da amostragem priorizada (padrão 0.4; 1 = correção completa)\n");
+    printf("  --state-spec D  discretização do estado: default, coarse ou near-paddle (padrão %s)\n",
+           state_spec_default()->name);
+    printf("  --qhash N       Q-table esparsa (hash) para até N estados visitados\n");
+    printf("  --load ARQ      começa da Q-table salva em ARQ (mapeada, sem cópia)\n");
+    printf("  --save ARQ      salva a Q-table ao final\n");
+    printf("  --checkpoint ARQ        grava checkpoints periódicos em ARQ (em segundo plano)\n");
+    printf("  --checkpoint-every N    episódios entre checkpoints (padrão 1000)\n");
+    printf("  --resume                continua o treino do checkpoint (padrão %s)\n", DEFAULT_CHECKPOINT);
+    printf("  --record ARQ    grava as ações do último episódio (modo de um jogo)\n");
+    printf("  --replay ARQ    reproduz um episódio gravado e confere o estado final\n");
+    printf("  --telemetry ARQ         grava telemetria do treino em ARQ (JSONL, ou CSV se terminar em .csv)\n");
+    printf("  --telemetry-every S     segundos entre registros de telemetria (padrão %.0f)\n", TELEMETRY_DEFAULT_INTERVAL);
+    printf("  --sweep ARQ     varredura de hiperparâmetros descrita em ARQ (--threads = tamanho do pool)\n");
+    printf("  --sweep-out ARQ tabela de resultados da varredura (padrão %s)\n", DEFAULT_SWEEP_OUT);
+    printf("  --level ARQ     joga o nível binário ARQ em vez do embutido\n");
+    printf("  --level-grid RxC        gera um nível cheio de R fileiras e C colunas (até %dx%d)\n",
+           LEVEL_MAX_ROWS, LEVEL_MAX_COLS);
+    printf("  --save-level ARQ        grava o nível em uso em ARQ\n");
+    printf("  --export-policy ARQ     compila a política gulosa (2 bits por estado) em ARQ ao final\n");
+    printf("  --policy-margins        inclui na política a margem de confiança de cada estado\n");
+    printf("  --play-policy ARQ       joga --episodes episódios com a política ARQ (sem Q-table)\n");
+}
+
+// Reproduz um episódio gravado; sucesso se o estado final bate bit a bit
+static int ReplayLog(const char *path, const Level *level) {
+    ActionLog log;
+    if (!actionlog_load(&log, path)) {
+        fprintf(stderr, "Registro inválido: %s\n", path);
+        return 1;
+    }
+    if (!actionlog_level_matches(&log, level)) {
+        fprintf(stderr, "%s foi gravado em outro nível (use o mesmo --level da gravação)\n", path);
+        actionlog_free(&log);
+        return 1;
+    }
+    SimState sim;
+    uint64_t hash = actionlog_replay(&log, level, &sim);
+    bool match = (hash == log.finalHash);
+    printf("%ld passos, score %d, hash %016llx: %s\n", log.count, sim.score, (unsigned long long)hash,
+           match ? "idêntico à gravação" : "DIVERGE da gravação");
+    actionlog_free(&log);
+    return match ? 0 : 1;
+}
+
+// Joga episódios só com a política compilada: sem Q-table e sem aprendizado
+static int PlayPolicy(const char *path, long episodes, long maxSteps, float dt, int collision, const Level *level,
+                      uint64_t seed) {
+    Policy policy;
+    if (!policy_load(&policy, path)) {
+        fprintf(stderr, "Política inválida ou incompatível: %s\n", path);
+        return 1;
+    }
+    SimState sim;
+    sim_init(&sim, dt, rng_env_seed(seed, 0));
+    sim.collision = collision;
+    sim_set_level(&sim, level);
+    long totalSteps = 0, totalScore = 0;
+    double start = NowSeconds();
+    for (long episode = 0; episode < episodes; episode++) {
+        sim_reset(&sim);
+        long steps = 0;
+        while (!sim.gameOver && (maxSteps <= 0 || steps < maxSteps)) {
+            policy_step(&policy, &sim);
+            steps++;
+        }
+        totalSteps += steps;
+        totalScore += sim.score;
+    }
+    double elapsed = NowSeconds() - start;
+    printf("%ld episódios, score médio %.2f, %ld passos em %.2f s (%.0f passos/s)\n", episodes,
+           episodes > 0 ? (float)totalScore / episodes : 0.0f, totalSteps, elapsed,
+           elapsed > 0.0 ? totalSteps / elapsed : 0.0);
+    printf("Política: %s, %zu bytes de ações%s\n", policy.spec->name, POLICY_ACTION_BYTES(policy.spec->nStates),
+           policy.margins ? " + margens" : "");
+    policy_free(&policy);
+    return 0;
+}
+
+// Monta os metadados de checkpoint com o estado atual do treino
+static QTableMeta MakeMeta(const TrainParams *params, float epsilon, long episode, long steps,
+                           uint64_t seed, const Rng *simRng, const Rng *agentRng) {
+    QTableMeta meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.alpha = params->alpha;
+    meta.gamma = params->gamma;
+    meta.epsilon = epsilon;
+    meta.episodes = episode;
+    meta.steps = steps;
+    meta.seed = seed;
+    meta.simRng = simRng ? simRng->state : 0;
+    meta.agentRng = agentRng ? agentRng->state : 0;
+    return meta;
+}
+
+// Varredura de hiperparâmetros: treinos independentes num pool de threads
+static int RunSweep(const char *specPath, const char *outPath, int threads, float dt, int collision,
+                    const Level *level, uint64_t seed) {
+    SweepSpec spec;
+    char err[512];
+    if (!sweep_load_spec(&spec, specPath, err, sizeof(err))) {
+        fprintf(stderr, "Especificação inválida: %s\n", err);
+        return 1;
+    }
+    int count = 0;
+    SweepConfig *configs = sweep_expand(&spec, seed, &count);
+    SweepResult *results = configs ? (SweepResult *)calloc(count, sizeof(SweepResult)) : NULL;
+    if (!results) {
+        fprintf(stderr, "Varredura grande demais (limite de %d configurações)\n", SWEEP_MAX_CONFIGS);
+        free(configs);
+        return 1;
+    }
+    printf("Varredura: %d configurações\n", count);
+
+    double start = NowSeconds();
+    int status = 0;
+    if (!sweep_run(configs, count, threads, dt, collision, level, results)) {
+        fprintf(stderr, "Falha ao iniciar o pool da varredura\n");
+        status = 1;
+    } else {
+        printf("Varredura concluída em %.2f s\n", NowSeconds() - start);
+        if (sweep_write_csv(outPath, configs, results, count)) {
+            printf("Resultados em %s\n", outPath);
+        } else {
+            fprintf(stderr, "Falha ao gravar %s\n", outPath);
+            status = 1;
+        }
+    }
+    sweep_free_results(results, count);
+    free(results);
+    free(configs);
+    return status;
+}
+
+/*
+ * Treino do agente linear: só pesos, sem Q-table. --load/--save leem e gravam
+ * o arquivo de pesos; checkpoints, lote e buffer de experiência não se aplicam.
+ */
+static int TrainLinear(const TrainParams *params, long episodes, long maxSteps, float dt, int collision, uint64_t seed,
+                       const Level *level, int threads, const char *loadPath, const char *savePath,
+                       Telemetry *telemetry) {
+    LinearQ *L = NULL;
+    if (posix_memalign((void **)&L, 32, sizeof(LinearQ)) != 0) return 1;
+    if (loadPath) {
+        if (!linear_load(L, loadPath)) {
+            fprintf(stderr, "Pesos inválidos ou incompatíveis: %s\n", loadPath);
+            free(L);
+            return 1;
+        }
+    } else {
+        linear_init(L);
+    }
+    printf("Agente linear: %d features x %d ações (%zu bytes), produtos escalares %s\n",
+           LINEAR_FEATURES, N_ACTIONS, sizeof(L->w), linear_isa_name());
+
+    long totalSteps = 0;
+    double start = NowSeconds();
+    if (threads > 0) {
+        TrainerConfig cfg = { threads, episodes, maxSteps, dt, collision, seed, *params, 0, 0, NULL, 0, NULL, 0, 0, L, telemetry,
+                              level };
+        TrainerStats *stats = (TrainerStats*)calloc(threads, sizeof(TrainerStats));
+        if (!stats || !trainer_run(NULL, &cfg, stats)) {
+            fprintf(stderr, "Falha ao iniciar %d threads de treino\n", threads);
+            free(stats);
+            free(L);
+            return 1;
+        }
+        for (int t = 0; t < threads; t++) totalSteps += stats[t].steps;
+        free(stats);
+    } else {
+        SimState sim;
+        sim_init(&sim, dt, rng_env_seed(seed, 0));
+        sim.collision = collision;
+        sim_set_level(&sim, level);
+        Rng rng;
+        rng_seed(&rng, rng_agent_seed(seed, 0));
+        float epsilon = params->epsilon;
+        int totalScore = 0;
+        TelemetrySlot *slot = telemetry_slot(telemetry, 0);
+        for (long episode = 1; episode <= episodes; episode++) {
+            TrainEpisodeStats es;
+            int score = train_episode_linear(L, &sim, params, epsilon, maxSteps, &es, &rng);
+            telemetry_episode(slot, &es, score, epsilon);
+            totalScore += score;
+            totalSteps += es.steps;
+            if (episode % 100 == 0) {
+                printf("Episódio %ld - Score médio: %.2f - Epsilon: %.3f\n", episode, (float)totalScore/100, epsilon);
+                totalScore = 0;
+            }
+            epsilon = train_decay_epsilon(params, epsilon);
+        }
+    }
+    double elapsed = NowSeconds() - start;
+    printf("%ld episódios, %ld passos em %.2f s (%.0f passos/s)\n", episodes, totalSteps, elapsed,
+           elapsed > 0.0 ? totalSteps / elapsed : 0.0);
+
+    int status = 0;
+    if (savePath && !linear_save(L, savePath)) {
+        fprintf(stderr, "Falha ao salvar os pesos em %s\n", savePath);
+        status = 1;
+    }
+    free(L);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    long episodes = 1000;
+    long maxSteps = 20000;
+    float dt = SIM_DT;
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *savePath = NULL;
+    const char *loadPath = NULL;
+    int batch = 0;
+    int threads = 0;
+    const char *checkpointPath = NULL;
+    long checkpointEvery = 1000;
+    bool resume = false;
+    int collision = SIM_COLLISION_DISCRETE;
+    long replayCapacity = 0;
+    int replayBatch = 32;
+    int replayEvery = 4;
+    float replayPriority = 0.0f;
+    float replayBeta = 0.4f;
+    TrainParams params = TRAIN_PARAMS_DEFAULT;
+    long hashStates = 0;
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    const char *sweepPath = NULL;
+    const char *sweepOut = DEFAULT_SWEEP_OUT;
+    const char *telemetryPath = NULL;
+    double telemetryEvery = TELEMETRY_DEFAULT_INTERVAL;
+    const char *levelPath = NULL;
+    const char *saveLevelPath = NULL;
+    int gridRows = 0, gridCols = 0;
+    const char *exportPolicyPath = NULL;
+    bool policyMargins = false;
+    const char *playPolicyPath = NULL;
+    const StateSpec *stateSpec = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--episodes") == 0 && i + 1 < argc) episodes = atol(argv[++i]);
+        else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc) maxSteps = atol(argv[++i]);
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) dt = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) batch = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--qhash") == 0 && i + 1 < argc) hashStates = atol(argv[++i]);
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) loadPath = argv[++i];
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) savePath = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) checkpointPath = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) checkpointEvery = atol(argv[++i]);
+        else if (strcmp(argv[i], "--resume") == 0) resume = true;
+        else if (strcmp(argv[i], "--ccd") == 0) collision = SIM_COLLISION_SWEPT;
+        else if (strcmp(argv[i], "--learner") == 0 && i + 1 < argc) {
+            params.learner = train_learner_parse(argv[++i]);
+            if (params.learner < 0) {
+                fprintf(stderr, "Regra de aprendizado desconhecida: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--lambda") == 0 && i + 1 < argc) params.lambda = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--exp-replay") == 0 && i + 1 < argc) replayCapacity = atol(argv[++i]);
+        else if (strcmp(argv[i], "--exp-batch") == 0 && i + 1 < argc) replayBatch = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--exp-every") == 0 && i + 1 < argc) replayEvery = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--exp-priority") == 0 && i + 1 < argc) replayPriority = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--exp-beta") == 0 && i + 1 < argc) replayBeta = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) telemetryPath = argv[++i];
+        else if (strcmp(argv[i], "--telemetry-every") == 0 && i + 1 < argc) telemetryEvery = atof(argv[++i]);
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) sweepPath = argv[++i];
+        else if (strcmp(argv[i], "--sweep-out") == 0 && i + 1 < argc) sweepOut = argv[++i];
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) levelPath = argv[++i];
+        else if (strcmp(argv[i], "--save-level") == 0 && i + 1 < argc) saveLevelPath = argv[++i];
+        else if (strcmp(argv[i], "--export-policy") == 0 && i + 1 < argc) exportPolicyPath = argv[++i];
+        else if (strcmp(argv[i], "--policy-margins") == 0) policyMargins = true;
+        else if (strcmp(argv[i], "--play-policy") == 0 && i + 1 < argc) playPolicyPath = argv[++i];
+        else if (strcmp(argv[i], "--state-spec") == 0 && i + 1 < argc) {
+            stateSpec = state_spec_find(argv[++i]);
+            if (!stateSpec) {
+                fprintf(stderr, "Discretização desconhecida: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--level-grid") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &gridRows, &gridCols) != 2) {
+                fprintf(stderr, "Grade inválida (use RxC): %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--headless") == 0) continue;  // aceito por compatibilidade
+        else {
+            PrintUsage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    // Nível: uma só imagem, compartilhada por todos os jogos e threads
+    Level levelImage;
+    const Level *level = level_builtin();
+    if (levelPath) {
+        char err[256];
+        if (!level_load(&levelImage, levelPath, err, sizeof(err))) {
+            fprintf(stderr, "Nível inválido: %s\n", err);
+            return 1;
+        }
+        level = &levelImage;
+    } else if (gridRows > 0 || gridCols > 0) {
+        if (!level_grid(&levelImage, gridRows, gridCols)) {
+            fprintf(stderr, "Grade %dx%d não cabe na tela (até %dx%d)\n", gridRows, gridCols,
+                    LEVEL_MAX_ROWS, LEVEL_MAX_COLS);
+            return 1;
+        }
+        level = &levelImage;
+    }
+    if (level != level_builtin()) {
+        printf("Nível: %dx%d, %zu bytes por jogo para os tijolos vivos%s\n", level->rows, level->cols,
+               (size_t)level->rows * level->words * sizeof(uint64_t), level->multiHit ? " (+ contadores de acertos)" : "");
+    }
+
+    // Daqui em diante toda saída passa por `cleanup`, que para as threads de
+    // fundo e libera o que já foi alocado
+    int status = 1;
+    Telemetry telemetryState;
+    Telemetry *telemetry = NULL;
+    QTable *Q = NULL;
+    Checkpointer ck;
+    Checkpointer *checkpoint = NULL;
+    ReplayBuffer replayBuffer;
+    ReplayBuffer *replay = NULL;
+
+    if (saveLevelPath) {
+        if (!level_save(level, saveLevelPath)) {
+            fprintf(stderr, "Falha ao gravar o nível em %s\n", saveLevelPath);
+            goto cleanup;
+        }
+        printf("Nível gravado em %s\n", saveLevelPath);
+    }
+
+    if (replayPath) {
+        status = ReplayLog(replayPath, level);
+        goto cleanup;
+    }
+    if (playPolicyPath) {
+        status = PlayPolicy(playPolicyPath, episodes, maxSteps, dt, collision, level, seed);
+        goto cleanup;
+    }
+    if (sweepPath) {
+        status = RunSweep(sweepPath, sweepOut, threads, dt, collision, level, seed);
+        goto cleanup;
+    }
+
+    // Telemetria: um slot por thread de treino, gravado em segundo plano
+    if (telemetryPath) {
+        if (!telemetry_start(&telemetryState, telemetryPath, threads > 0 ? threads : 1, telemetryEvery)) {
+            fprintf(stderr, "Falha ao iniciar a telemetria em %s\n", telemetryPath);
+            goto cleanup;
+        }
+        telemetry = &telemetryState;
+    }
+
+    if (params.learner == LEARNER_LINEAR) {
+        if (batch > 0 || replayCapacity > 0 || checkpointPath || resume || hashStates > 0 || recordPath || exportPolicyPath
+            || stateSpec)
+            fprintf(stderr, "--learner linear ignora --batch, --exp-replay, --checkpoint, --resume, --qhash, --record, "
+                            "--export-policy e --state-spec\n");
+        status = TrainLinear(&params, episodes, maxSteps, dt, collision, seed, level, threads, loadPath, savePath,
+                             telemetry);
+        goto cleanup;
+    }
+    if (collision == SIM_COLLISION_SWEPT && batch > 0 && threads <= 0)
+        fprintf(stderr, "--ccd não é suportado com --batch; o lote usa colisão discreta\n");
+    if (replayCapacity > 0 && batch > 0 && threads <= 0)
+        fprintf(stderr, "--exp-replay não é suportado com --batch; o lote atualiza a cada passo\n");
+    if (params.learner != LEARNER_Q && (replayCapacity > 0 || (batch > 0 && threads <= 0)))
+        fprintf(stderr, "--learner %s não é suportado com --exp-replay nem --batch; usando Q-Learning de um passo\n",
+                train_learner_name(params.learner));
+    if (recordPath && (threads > 0 || batch > 0))
+        fprintf(stderr, "--record só grava no modo de um jogo; ignorado\n");
+
+    if (resume && !checkpointPath) checkpointPath = DEFAULT_CHECKPOINT;
+
+    // Retomada: Q-table, episódio, epsilon e geradores vêm do checkpoint
+    QTableMeta resumed;
+    bool haveResume = false;
+    if (resume) {
+        Q = map_qtable(checkpointPath, &resumed, true);
+        if (Q) {
+            haveResume = true;
+            seed = resumed.seed;
+            printf("Retomando de %s: episódio %lld, epsilon %.3f\n", checkpointPath,
+                   (long long)resumed.episodes, resumed.epsilon);
+        } else {
+            printf("Checkpoint %s ausente ou inválido: começando do zero\n", checkpointPath);
+        }
+    }
+    if (!Q) Q = loadPath ? map_qtable(loadPath, NULL, true) : init_q_table(stateSpec);
+    if (!Q) {
+        if (loadPath) fprintf(stderr, "Q-table inválida ou incompatível: %s\n", loadPath);
+        else fprintf(stderr, "Falha ao alocar a Q-table\n");
+        goto cleanup;
+    }
+    // Uma tabela carregada traz a sua discretização
+    if (stateSpec && Q->spec != stateSpec) {
+        fprintf(stderr, "A Q-table carregada usa a discretização %s, não %s\n", Q->spec->name, stateSpec->name);
+        goto cleanup;
+    }
+    if (Q->spec != state_spec_default()) printf("Discretização: %s (%d estados)\n", Q->spec->name, Q->nStates);
+    if (hashStates > 0) {
+        // Armazenamento esparso: copia as linhas já aprendidas (de --load/--resume)
+        QTable *hashed = init_q_table_hashed(Q->spec, hashStates, Q);
+        free_q_table(Q);
+        Q = hashed;
+        if (!Q) {
+            fprintf(stderr, "Falha ao criar a Q-table esparsa para %ld estados\n", hashStates);
+            goto cleanup;
+        }
+    }
+
+    if (checkpointPath) {
+        if (!checkpoint_start(&ck, checkpointPath, Q->spec)) {
+            fprintf(stderr, "Falha ao iniciar os checkpoints em %s\n", checkpointPath);
+            goto cleanup;
+        }
+        checkpoint = &ck;
+    }
+    if (checkpointEvery <= 0) checkpointEvery = 1000;
+
+    float epsilon = haveResume ? resumed.epsilon : params.epsilon;
+    long firstEpisode = haveResume ? (long)resumed.episodes : 0;
+    long episode = firstEpisode;
+    int totalScore = 0;
+    long totalSteps = haveResume ? (long)resumed.steps : 0;
+    long startSteps = totalSteps;
+    Rng agentRng;
+    rng_seed(&agentRng, rng_agent_seed(seed, 0));
+    Rng simRng = { 0 };
+    bool haveRngs = false;      // geradores do jogo 0 (thread 0 ou jogo 0 do lote) para o checkpoint final
+
+    // Buffer de experiência: um só, compartilhado por todas as threads
+    if (replayCapacity > 0) {
+        if (!replay_init(&replayBuffer, replayCapacity, replayPriority, replayBeta)) {
+            fprintf(stderr, "Falha ao alocar o buffer de %ld transições\n", replayCapacity);
+            goto cleanup;
+        }
+        replay = &replayBuffer;
+    }
+
+    double start = NowSeconds();
+    if (threads > 0) {
+        TrainerConfig cfg = { threads, episodes, maxSteps, dt, collision, seed, params, firstEpisode, startSteps, checkpoint, checkpointEvery,
+                              replay, replayBatch, replayEvery, NULL, telemetry, level };
+        TrainerStats *stats = (TrainerStats*)calloc(threads, sizeof(TrainerStats));
+        if (!stats || !trainer_run(Q, &cfg, stats)) {
+            fprintf(stderr, "Falha ao iniciar %d threads de treino\n", threads);
+            free(stats);
+            goto cleanup;
+        }
+        for (int t = 0; t < threads; t++) totalSteps += stats[t].steps;
+        simRng.state = stats[0].simRng;
+        agentRng.state = stats[0].agentRng;
+        haveRngs = true;
+        free(stats);
+        episode = episodes > firstEpisode ? episodes : firstEpisode;
+        epsilon = train_epsilon_at(&params, episode);
+    } else if (batch > 0) {
+        TrainBatch tb;
+        // Os jogos em andamento não são salvos: retoma o cronograma com sementes novas
+        if (!train_batch_init(&tb, batch, dt, rng_resume_seed(seed, firstEpisode), level, Q->spec)) {
+            fprintf(stderr, "Falha ao alocar o lote de %d jogos\n", batch);
+            goto cleanup;
+        }
+        while (episode < episodes) {
+            if (train_batch_step(Q, &tb, epsilon, params.alpha, params.gamma, maxSteps) > 0) {
+                for (int i = 0; i < batch && episode < episodes; i++) {
+                    if (!(tb.events[i] & SIM_EVENT_GAME_OVER)) continue;
+                    episode++;
+                    totalScore += tb.env.episodeScore[i];
+                    telemetry_episode(telemetry_slot(telemetry, 0), NULL, tb.env.episodeScore[i], epsilon);
+                    if (episode % 100 == 0) {
+                        printf("Episódio %ld - Score médio: %.2f - Epsilon: %.3f\n", episode, (float)totalScore/100, epsilon);
+                        totalScore = 0;
+                    }
+                    epsilon = train_decay_epsilon(&params, epsilon);
+                    if (checkpoint && episode % checkpointEvery == 0) {
+                        QTableMeta meta = MakeMeta(&params, epsilon, episode, totalSteps, seed, &tb.env.rng[0], &tb.rng[0]);
+                        checkpoint_submit(checkpoint, Q, &meta, false);
+                    }
+                }
+            }
+            totalSteps += batch;
+        }
+        simRng = tb.env.rng[0];
+        agentRng = tb.rng[0];
+        haveRngs = true;
+        train_batch_free(&tb);
+    } else {
+        SimState sim;
+        sim_init(&sim, dt, rng_env_seed(seed, 0));
+        sim.collision = collision;
+        sim_set_level(&sim, level);
+        if (haveResume) {
+            // Checkpoints são feitos entre episódios: basta restaurar os geradores.
+            // Um estado zero (checkpoint antigo) travaria o xorshift: fica a semente.
+            if (resumed.simRng) sim.rng.state = resumed.simRng;
+            if (resumed.agentRng) agentRng.state = resumed.agentRng;
+        }
+        ActionLog log = { 0 };
+        ReplayActor *actor = NULL;
+        if (replay) {
+            actor = (ReplayActor *)malloc(sizeof(ReplayActor));
+            if (!actor) {
+                fprintf(stderr, "Falha ao alocar o ator do buffer de experiência\n");
+                goto cleanup;
+            }
+            train_replay_actor_init(actor, replay, replayBatch, replayEvery);
+        }
+        TraceAgent traceAgent;
+        TraceAgent *traces = NULL;
+        if (params.learner != LEARNER_Q && !replay) {
+            if (!train_trace_agent_init(&traceAgent)) {
+                fprintf(stderr, "Falha ao alocar os traços de elegibilidade\n");
+                free(actor);
+                goto cleanup;
+            }
+            traces = &traceAgent;
+        }
+        while (episode < episodes) {
+            // Grava o último episódio para conferência com --replay
+            bool recording = recordPath && episode == episodes - 1;
+            if (recording) actionlog_begin(&log, &sim);
+
+            TrainEpisodeStats es;
+            int score = train_episode(Q, &sim, &params, epsilon, maxSteps, &es, &agentRng, actor, traces);
+            telemetry_episode(telemetry_slot(telemetry, 0), &es, score, epsilon);
+            totalScore += score;
+            totalSteps += es.steps;
+            episode++;
+
+            if (recording) {
+                actionlog_end(&log, &sim);
+                if (actionlog_save(&log, recordPath))
+                    printf("Episódio gravado em %s (%ld passos, hash %016llx)\n", recordPath, log.count,
+                           (unsigned long long)log.finalHash);
+                else
+                    fprintf(stderr, "Falha ao gravar o episódio em %s\n", recordPath);
+            }
+
+            if (episode % 100 == 0) {
+                printf("Episódio %ld - Score médio: %.2f - Epsilon: %.3f\n", episode, (float)totalScore/100, epsilon);
+                totalScore = 0;
+            }
+
+            epsilon = train_decay_epsilon(&params, epsilon);
+            if (checkpoint && episode % checkpointEvery == 0) {
+                QTableMeta meta = MakeMeta(&params, epsilon, episode, totalSteps, seed, &sim.rng, &agentRng);
+                checkpoint_submit(checkpoint, Q, &meta, false);
+            }
+        }
+        actionlog_free(&log);
+        free(actor);
+        if (traces) train_trace_agent_free(traces);
+        simRng = sim.rng;
+        haveRngs = true;
+    }
+    double elapsed = NowSeconds() - start;
+    if (telemetry) {
+        // Fecha o último intervalo antes de salvar
+        telemetry_stop(telemetry);
+        telemetry = NULL;
+    }
+
+    printf("%ld episódios, %ld passos em %.2f s (%.0f passos/s)\n",
+           episode - firstEpisode, totalSteps - startSteps, elapsed,
+           elapsed > 0.0 ? (totalSteps - startSteps) / elapsed : 0.0);
+
+    if (Q->hash) {
+        QHashStats hs;
+        qhash_stats(Q->hash, &hs);
+        printf("Q-table esparsa: %ld de %d estados (ocupação %.1f%% de %ld posições), sondagem média %.2f, máx %d, "
+               "%.1f KB (densa: %.1f KB), %ld inserções recusadas\n",
+               hs.states, Q->nStates, 100.0 * hs.load, hs.capacity, hs.meanProbe, hs.maxProbe, hs.bytes / 1024.0,
+               (double)Q->nStates * Q_STRIDE * sizeof(float) / 1024.0, hs.overflow);
+    }
+
+    QTableMeta meta = MakeMeta(&params, epsilon, episode, totalSteps, seed,
+                               haveRngs ? &simRng : NULL, haveRngs ? &agentRng : NULL);
+    if (checkpoint) {
+        // Checkpoint final: espera a escrita anterior e grava o estado completo
+        checkpoint_submit(checkpoint, Q, &meta, true);
+    }
+    if (savePath && !save_qtable_meta(Q, &meta, savePath)) {
+        fprintf(stderr, "Falha ao salvar a Q-table em %s\n", savePath);
+    }
+    if (exportPolicyPath) {
+        Policy policy;
+        if (policy_compile(&policy, Q, policyMargins) && policy_save(&policy, exportPolicyPath))
+            printf("Política gravada em %s (%zu bytes de ações%s)\n", exportPolicyPath,
+                   POLICY_ACTION_BYTES(Q->nStates), policyMargins ? " + margens" : "");
+        else
+            fprintf(stderr, "Falha ao gravar a política em %s\n", exportPolicyPath);
+        policy_free(&policy);
+    }
+
+    status = 0;
+
+cleanup:
+    if (checkpoint) checkpoint_stop(checkpoint);
+    if (telemetry) telemetry_stop(telemetry);
+    if (replay) replay_free(replay);
+    free_q_table(Q);
+    if (level == &levelImage) level_free(&levelImage);
+    return status;
+}
@@ -0,0 +1,247 @@
+#include "level.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Geometria do nível embutido (a grade original do jogo)
+#define BUILTIN_OFFSET_X  ((SCREEN_W - (COLS * (BRICK_WIDTH + BRICK_SP) - BRICK_SP)) / 2)
+#define BUILTIN_OFFSET_Y  60
+
+// A bola nasce no centro da tela: a grade tem de terminar acima dela
+#define LEVEL_MAX_BOTTOM  (SCREEN_H / 2 - 2 * BALL_R)
+
+// Margem lateral das grades geradas por level_grid
+#define GRID_SIDE 8
+
+#if ROWS != 5 || COLS != 10
+#error "As tabelas do nível embutido abaixo são de 5 fileiras × 10 colunas"
+#endif
+
+// Fileira r do embutido: cor r, um ponto de vida
+#define BUILTIN_ROW(r) LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), \
+                       LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1), LEVEL_CELL(r, 1)
+
+static const uint8_t builtinCells[ROWS * COLS] = {
+    BUILTIN_ROW(0), BUILTIN_ROW(1), BUILTIN_ROW(2), BUILTIN_ROW(3), BUILTIN_ROW(4)
+};
+
+#define BUILTIN_ALIVE ((1ull << COLS) - 1)
+static const uint64_t builtinAlive[ROWS] = {
+    BUILTIN_ALIVE, BUILTIN_ALIVE, BUILTIN_ALIVE, BUILTIN_ALIVE, BUILTIN_ALIVE
+};
+
+static const Level builtinLevel = {
+    .rows = ROWS, .cols = COLS, .words = 1,
+    .offsetX = BUILTIN_OFFSET_X, .offsetY = BUILTIN_OFFSET_Y,
+    .pitchX = BRICK_WIDTH + BRICK_SP, .pitchY = BRICK_HEIGHT + BRICK_SP,
+    .brickW = BRICK_WIDTH, .brickH = BRICK_HEIGHT,
+    .multiHit = false,
+    // ColorFromHSV(r * 36, 0.7, 0.9), como o jogo original
+    .paletteCount = ROWS,
+    .palette = { { 229, 68, 68, 255 }, { 229, 165, 68, 255 }, { 197, 229, 68, 255 },
+                 { 100, 229, 68, 255 }, { 68, 229, 133, 255 } },
+    .cells = builtinCells,
+    .alive = builtinAlive,
+    .storage = NULL
+};
+
+const Level *level_builtin(void) {
+    return &builtinLevel;
+}
+
+// Mesma conta do ColorFromHSV do raylib (disponível também no headless)
+static Color HsvColor(float hue, float saturation, float value) {
+    Color color = { 0, 0, 0, 255 };
+    unsigned char *channel[3] = { &color.r, &color.g, &color.b };
+    const float n[3] = { 5.0f, 3.0f, 1.0f };
+    for (int i = 0; i < 3; i++) {
+        float k = fmodf(n[i] + hue / 60.0f, 6.0f);
+        float t = 4.0f - k;
+        k = (t < k) ? t : k;
+        k = (k < 1.0f) ? k : 1.0f;
+        k = (k > 0.0f) ? k : 0.0f;
+        *channel[i] = (unsigned char)((value - value * saturation * k) * 255.0f);
+    }
+    return color;
+}
+
+// Reserva cells e alive de um nível rows × cols (alive zerado)
+static bool AllocLevel(Level *level, int rows, int cols, uint8_t **cells, uint64_t **alive) {
+    int words = (cols + 63) / 64;
+    size_t aliveBytes = (size_t)rows * words * sizeof(uint64_t);
+    void *storage = calloc(1, aliveBytes + (size_t)rows * cols);
+    if (!storage) return false;
+    level->rows = rows;
+    level->cols = cols;
+    level->words = words;
+    level->storage = storage;
+    *alive = (uint64_t *)storage;
+    *cells = (uint8_t *)storage + aliveBytes;
+    level->alive = *alive;
+    level->cells = *cells;
+    return true;
+}
+
+// Geometria implícita: grade centralizada na horizontal
+static void SetGeometry(Level *level, int brickW, int brickH, int spacing, int offsetY) {
+    level->brickW = (float)brickW;
+    level->brickH = (float)brickH;
+    level->pitchX = (float)(brickW + spacing);
+    level->pitchY = (float)(brickH + spacing);
+    level->offsetX = (float)((SCREEN_W - (level->cols * (brickW + spacing) - spacing)) / 2);
+    level->offsetY = (float)offsetY;
+}
+
+// Monta o bitset inicial e multiHit a partir das células
+static void BuildAlive(Level *level, uint8_t *cells, uint64_t *alive) {
+    level->multiHit = false;
+    for (int r = 0; r < level->rows; ++r)
+    for (int c = 0; c < level->cols; ++c) {
+        int hp = LEVEL_CELL_HP(cells[r * level->cols + c]);
+        if (hp > 0) alive[r * level->words + (c >> 6)] |= 1ull << (c & 63);
+        if (hp > 1) level->multiHit = true;
+    }
+}
+
+bool level_load(Level *level, const char *filename, char *err, size_t errSize) {
+    memset(level, 0, sizeof(*level));
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        snprintf(err, errSize, "não foi possível abrir %s", filename);
+        return false;
+    }
+
+    LevelFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, LEVEL_MAGIC, sizeof(header.magic)) != 0) {
+        snprintf(err, errSize, "%s não é um nível (%s)", filename, LEVEL_MAGIC);
+        fclose(file);
+        return false;
+    }
+    int rows = header.rows, cols = header.cols;
+    int width = cols * (header.brickW + header.spacing) - header.spacing;
+    int bottom = header.offsetY + rows * (header.brickH + header.spacing) - header.spacing;
+    const char *bad = NULL;
+    if (rows < 1 || rows > LEVEL_MAX_ROWS || cols < 1 || cols > LEVEL_MAX_COLS) bad = "dimensões fora de 1..64 × 1..256";
+    else if (header.brickW == 0 || header.brickH == 0) bad = "tijolo de tamanho zero";
+    else if (width > SCREEN_W) bad = "a grade é mais larga que a tela";
+    else if (bottom > LEVEL_MAX_BOTTOM) bad = "a grade desce além do meio da tela";
+    else if (header.paletteCount < 1 || header.paletteCount > LEVEL_PALETTE) bad = "paleta fora de 1..16 cores";
+    if (bad) {
+        snprintf(err, errSize, "%s: %s", filename, bad);
+        fclose(file);
+        return false;
+    }
+
+    uint8_t *cells;
+    uint64_t *alive;
+    if (!AllocLevel(level, rows, cols, &cells, &alive)) {
+        snprintf(err, errSize, "sem memória para o nível");
+        fclose(file);
+        return false;
+    }
+    level->paletteCount = header.paletteCount;
+    bool ok = fread(level->palette, sizeof(Color), (size_t)header.paletteCount, file) == header.paletteCount
+           && fread(cells, 1, (size_t)rows * cols, file) == (size_t)rows * cols;
+    fclose(file);
+    if (!ok) {
+        snprintf(err, errSize, "%s: arquivo truncado", filename);
+        level_free(level);
+        return false;
+    }
+    for (int i = 0; i < rows * cols; i++) {
+        if (LEVEL_CELL_HP(cells[i]) > LEVEL_MAX_HP || LEVEL_CELL_PALETTE(cells[i]) >= level->paletteCount) {
+            snprintf(err, errSize, "%s: tijolo %d (fileira %d, coluna %d) com cor ou vida inválida",
+                     filename, i, i / cols, i % cols);
+            level_free(level);
+            return false;
+        }
+    }
+
+    SetGeometry(level, header.brickW, header.brickH, header.spacing, header.offsetY);
+    BuildAlive(level, cells, alive);
+    return true;
+}
+
+bool level_save(const Level *level, const char *filename) {
+    LevelFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEVEL_MAGIC, sizeof(header.magic));
+    header.rows = (uint16_t)level->rows;
+    header.cols = (uint16_t)level->cols;
+    header.brickW = (uint16_t)level->brickW;
+    header.brickH = (uint16_t)level->brickH;
+    header.spacing = (uint16_t)(level->pitchX - level->brickW);
+    header.offsetY = (uint16_t)level->offsetY;
+    header.paletteCount = (uint8_t)level->paletteCount;
+
+    FILE *file = fopen(filename, "wb");
+    if (!file) return false;
+    size_t cells = (size_t)level->rows * level->cols;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+           && fwrite(level->palette, sizeof(Color), (size_t)level->paletteCount, file) == (size_t)level->paletteCount
+           && fwrite(level->cells, 1, cells, file) == cells;
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+bool level_grid(Level *level, int rows, int cols) {
+    memset(level, 0, sizeof(*level));
+    if (rows < 1 || rows > LEVEL_MAX_ROWS || cols < 1 || cols > LEVEL_MAX_COLS) return false;
+
+    // Grades maiores que a original ficam com 1 px entre tijolos
+    int spacing = (cols <= COLS && rows <= ROWS) ? BRICK_SP : 1;
+    int brickW = (SCREEN_W - 2 * GRID_SIDE + spacing) / cols - spacing;
+    int brickH = (LEVEL_MAX_BOTTOM - BUILTIN_OFFSET_Y + spacing) / rows - spacing;
+    if (brickH > BRICK_HEIGHT) brickH = BRICK_HEIGHT;
+    if (brickW < 1 || brickH < 1) return false;
+
+    uint8_t *cells;
+    uint64_t *alive;
+    if (!AllocLevel(level, rows, cols, &cells, &alive)) return false;
+    level->paletteCount = rows < LEVEL_PALETTE ? rows : LEVEL_PALETTE;
+    for (int i = 0; i < level->paletteCount; i++)
+        level->palette[i] = HsvColor(i * 360.0f / level->paletteCount, 0.7f, 0.9f);
+    for (int r = 0; r < rows; ++r) {
+        int hp = 1 + (rows - 1 - r) * LEVEL_MAX_HP / rows;   // LEVEL_MAX_HP no topo, 1 embaixo
+        for (int c = 0; c < cols; ++c) cells[r * cols + c] = LEVEL_CELL(r % level->paletteCount, hp);
+    }
+
+    SetGeometry(level, brickW, brickH, spacing, BUILTIN_OFFSET_Y);
+    BuildAlive(level, cells, alive);
+    return true;
+}
+
+void level_free(Level *level) {
+    if (level == &builtinLevel) return;
+    free(level->storage);
+    memset(level, 0, sizeof(*level));
+}
+
+static uint64_t HashBytes(uint64_t h, const void *data, size_t size) {
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) h = (h ^ p[i]) * 0x100000001B3ull;
+    return h;
+}
+
+uint64_t level_hash(const Level *level) {
+    if (!level) level = level_builtin();
+    uint64_t h = 0xCBF29CE484222325ull;
+    int32_t dims[2] = { level->rows, level->cols };
+    float geometry[6] = { level->offsetX, level->offsetY, level->pitchX, level->pitchY, level->brickW, level->brickH };
+    h = HashBytes(h, dims, sizeof(dims));
+    h = HashBytes(h, geometry, sizeof(geometry));
+    for (int i = 0; i < level->rows * level->cols; i++) {
+        uint8_t hp = LEVEL_CELL_HP(level->cells[i]);
+        h = HashBytes(h, &hp, 1);
+    }
+    return h ? h : 1;   // 0 fica para "desconhecido" nos registros
+}
+
+void level_reset(const Level *level, BrickField *field) {
+    size_t bytes = (size_t)level->rows * level->words * sizeof(uint64_t);
+    memcpy(field->alive, level->alive, bytes);
+    if (level->multiHit) {
+        for (int p = 0; p < LEVEL_HP_BITS; p++) memset(field->hits[p], 0, bytes);
+    }
+}
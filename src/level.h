@@ -0,0 +1,146 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "defs.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Níveis: imagem somente leitura com dimensões, paleta e pontos de vida de
+ * cada tijolo. Posição e tamanho de um tijolo saem da fileira e da coluna
+ * (grade regular), então o que muda durante o jogo é só o BrickField: um bit
+ * por tijolo vivo e, em níveis com tijolos de vários pontos de vida, dois
+ * planos de bits com os acertos já recebidos. Reiniciar o nível é um memcpy
+ * do bitset inicial, e quantas simulações quiserem (threads, varreduras)
+ * apontam para a mesma imagem.
+ *
+ * Arquivo: [LevelFileHeader][paletteCount × RGBA][rows × cols bytes]
+ * Cada byte de tijolo guarda o índice de paleta nos 4 bits altos e os pontos
+ * de vida nos 4 baixos (0 = célula vazia).
+ */
+
+#define LEVEL_MAGIC       "ARKLVL1"     // 7 caracteres + '\0'
+#define LEVEL_MAX_ROWS    64
+#define LEVEL_MAX_COLS    256
+#define LEVEL_MAX_WORDS   (LEVEL_MAX_COLS / 64)         // uint64_t por fileira
+#define LEVEL_FIELD_WORDS (LEVEL_MAX_ROWS * LEVEL_MAX_WORDS)
+#define LEVEL_PALETTE     16
+#define LEVEL_HP_BITS     2                             // planos do contador de acertos
+#define LEVEL_MAX_HP      (1 << LEVEL_HP_BITS)          // 4 pontos de vida
+
+#define LEVEL_CELL(palette, hp) ((uint8_t)(((palette) << 4) | (hp)))
+#define LEVEL_CELL_PALETTE(cell) ((cell) >> 4)
+#define LEVEL_CELL_HP(cell)      ((cell) & 15)
+
+// Imagem do nível (compartilhada, não muda depois de carregada)
+typedef struct {
+    int rows, cols;
+    int words;                  // uint64_t por fileira no bitset
+    float offsetX, offsetY;     // canto do tijolo (0, 0)
+    float pitchX, pitchY;       // distância entre colunas e entre fileiras
+    float brickW, brickH;
+    bool multiHit;              // algum tijolo com mais de 1 ponto de vida
+    int paletteCount;
+    Color palette[LEVEL_PALETTE];
+    const uint8_t *cells;       // rows × cols (LEVEL_CELL)
+    const uint64_t *alive;      // rows × words: tijolos presentes no início
+    void *storage;              // memória de cells e alive (NULL no embutido)
+} Level;
+
+// Estado dos tijolos de um jogo (índice r * level->words + palavra)
+typedef struct {
+    uint64_t alive[LEVEL_FIELD_WORDS];
+    uint64_t hits[LEVEL_HP_BITS][LEVEL_FIELD_WORDS];   // acertos recebidos (só multiHit)
+} BrickField;
+
+// Cabeçalho do arquivo (24 bytes, campos em endianness nativa)
+typedef struct {
+    char magic[8];
+    uint16_t rows, cols;
+    uint16_t brickW, brickH;    // px
+    uint16_t spacing;           // px entre tijolos vizinhos
+    uint16_t offsetY;           // topo da primeira fileira
+    uint8_t paletteCount;
+    uint8_t pad[3];
+} LevelFileHeader;
+
+/**
+ * Nível embutido: as 5 fileiras de 10 tijolos do jogo original.
+ * @return Imagem estática, válida durante todo o programa.
+ */
+const Level *level_builtin(void);
+
+/**
+ * Carrega um nível do formato binário e valida dimensões, paleta, pontos de
+ * vida e se a grade cabe na tela acima do paddle.
+ * @param level Saída (libere com level_free).
+ * @param filename Caminho do arquivo.
+ * @param err Buffer para a mensagem de erro.
+ * @param errSize Tamanho do buffer.
+ * @return true se carregou.
+ */
+bool level_load(Level *level, const char *filename, char *err, size_t errSize);
+
+/**
+ * Grava um nível no formato binário.
+ * @param level Nível.
+ * @param filename Caminho do arquivo.
+ * @return true se gravou.
+ */
+bool level_save(const Level *level, const char *filename);
+
+/**
+ * Gera uma grade cheia rows × cols com tijolos ajustados à largura da tela
+ * (cores por fileira; as fileiras de cima valem mais pontos de vida).
+ * @param level Saída (libere com level_free).
+ * @param rows Fileiras (1 .. LEVEL_MAX_ROWS).
+ * @param cols Colunas (1 .. LEVEL_MAX_COLS).
+ * @return false se as dimensões não cabem.
+ */
+bool level_grid(Level *level, int rows, int cols);
+
+/**
+ * Libera um nível carregado ou gerado (o embutido é ignorado).
+ * @param level Nível.
+ */
+void level_free(Level *level);
+
+/**
+ * Volta os tijolos ao estado inicial do nível.
+ * @param level Nível.
+ * @param field Estado dos tijolos.
+ */
+void level_reset(const Level *level, BrickField *field);
+
+/**
+ * Identidade do nível para os registros de episódios: FNV-1a da geometria da
+ * grade e dos pontos de vida de cada célula (as cores não mudam o jogo e
+ * ficam de fora).
+ * @param level Nível (NULL = embutido).
+ * @return Hash de 64 bits, nunca 0.
+ */
+uint64_t level_hash(const Level *level);
+
+/**
+ * Retângulo do tijolo (r, c).
+ * @param level Nível.
+ * @param r Fileira.
+ * @param c Coluna.
+ */
+static inline Rectangle level_brick_rect(const Level *level, int r, int c) {
+    return (Rectangle){ level->offsetX + c * level->pitchX, level->offsetY + r * level->pitchY,
+                        level->brickW, level->brickH };
+}
+
+/**
+ * Cor do tijolo (r, c).
+ * @param level Nível.
+ * @param r Fileira.
+ * @param c Coluna.
+ */
+static inline Color level_brick_color(const Level *level, int r, int c) {
+    return level->palette[LEVEL_CELL_PALETTE(level->cells[r * level->cols + c])];
+}
+
+#endif // LEVEL_H
@@ -0,0 +1,235 @@
+#include "linear.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LINEAR_HAVE_AVX2 1
+#endif
+
+// Escala das velocidades nas features (px/s)
+#define LINEAR_SPEED_SCALE 400.0f
+
+// Garante que as features enchem cargas AVX2 inteiras e que os blocos cabem
+typedef char LinearFeatureCheck[(LINEAR_FEATURES % 8 == 0 && 8 + LINEAR_TILES_LAND + LINEAR_TILES_BALL <= LINEAR_FEATURES) ? 1 : -1];
+
+/* ---------- Implementação escalar ---------- */
+
+static void ValuesScalar(const LinearQ *L, const float *phi, float *q) {
+    for (int a = 0; a < N_ACTIONS; a++) {
+        float acc = 0.0f;
+        for (int k = 0; k < LINEAR_FEATURES; k++) acc += L->w[a][k] * phi[k];
+        q[a] = acc;
+    }
+}
+
+static void AxpyScalar(float *w, const float *phi, float scale) {
+    for (int k = 0; k < LINEAR_FEATURES; k++) w[k] += scale * phi[k];
+}
+
+static float NormScalar(const float *phi) {
+    float acc = 0.0f;
+    for (int k = 0; k < LINEAR_FEATURES; k++) acc += phi[k] * phi[k];
+    return acc;
+}
+
+/* ---------- Implementação AVX2 + FMA ---------- */
+
+#ifdef LINEAR_HAVE_AVX2
+__attribute__((target("avx2,fma")))
+static inline float HorizontalSum(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+// Todas as ações numa passada: cada bloco de 8 features é carregado uma vez
+__attribute__((target("avx2,fma")))
+static void ValuesAvx2(const LinearQ *L, const float *phi, float *q) {
+    __m256 acc[N_ACTIONS];
+    for (int a = 0; a < N_ACTIONS; a++) acc[a] = _mm256_setzero_ps();
+    for (int k = 0; k < LINEAR_FEATURES; k += 8) {
+        __m256 x = _mm256_load_ps(phi + k);
+        for (int a = 0; a < N_ACTIONS; a++) acc[a] = _mm256_fmadd_ps(_mm256_load_ps(&L->w[a][k]), x, acc[a]);
+    }
+    for (int a = 0; a < N_ACTIONS; a++) q[a] = HorizontalSum(acc[a]);
+}
+
+__attribute__((target("avx2,fma")))
+static void AxpyAvx2(float *w, const float *phi, float scale) {
+    __m256 s = _mm256_set1_ps(scale);
+    for (int k = 0; k < LINEAR_FEATURES; k += 8) {
+        _mm256_store_ps(w + k, _mm256_fmadd_ps(s, _mm256_load_ps(phi + k), _mm256_load_ps(w + k)));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static float NormAvx2(const float *phi) {
+    __m256 acc = _mm256_setzero_ps();
+    for (int k = 0; k < LINEAR_FEATURES; k += 8) {
+        __m256 x = _mm256_load_ps(phi + k);
+        acc = _mm256_fmadd_ps(x, x, acc);
+    }
+    return HorizontalSum(acc);
+}
+#endif
+
+/* ---------- Despacho ---------- */
+
+static void (*ValuesImpl)(const LinearQ *, const float *, float *) = ValuesScalar;
+static void (*AxpyImpl)(float *, const float *, float) = AxpyScalar;
+static float (*NormImpl)(const float *) = NormScalar;
+static int activeIsa = LINEAR_ISA_SCALAR;
+
+static bool CpuHasAvx2(void) {
+#ifdef LINEAR_HAVE_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+int linear_set_isa(int isa) {
+#ifdef LINEAR_HAVE_AVX2
+    if (isa == LINEAR_ISA_AVX2 && CpuHasAvx2()) {
+        ValuesImpl = ValuesAvx2;
+        AxpyImpl = AxpyAvx2;
+        NormImpl = NormAvx2;
+        activeIsa = LINEAR_ISA_AVX2;
+        return activeIsa;
+    }
+#endif
+    if (isa == LINEAR_ISA_SCALAR) {
+        ValuesImpl = ValuesScalar;
+        AxpyImpl = AxpyScalar;
+        NormImpl = NormScalar;
+        activeIsa = LINEAR_ISA_SCALAR;
+    }
+    return activeIsa;
+}
+
+const char *linear_isa_name(void) {
+    return activeIsa == LINEAR_ISA_AVX2 ? "avx2" : "scalar";
+}
+
+void linear_init(LinearQ *L) {
+    memset(L, 0, sizeof(*L));
+    linear_set_isa(LINEAR_ISA_AVX2);
+}
+
+/* ---------- Features ---------- */
+
+// Acende os dois tiles triangulares vizinhos de v em [-1, 1]
+static inline void HatTiles(float *out, int tiles, float v) {
+    v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);    // sem chamar fminf/fmaxf
+    float t = (v + 1.0f) * 0.5f * (tiles - 1);
+    int i = (int)t;
+    if (i > tiles - 2) i = tiles - 2;
+    float frac = t - i;
+    out[i] = 1.0f - frac;
+    out[i + 1] = frac;
+}
+
+// x em que a bola chega à altura do paddle, refletindo nas paredes
+static float PredictLanding(Rectangle paddle, Ball ball) {
+    const float r = BALL_R;         // constante: a dobra abaixo não divide
+    float contactY = paddle.y - r;
+    float vy = ball.vel.y;
+    if (fabsf(vy) < 1e-3f) return ball.pos.x;
+    // Subindo: vai até o teto e volta
+    float dist = vy > 0.0f ? contactY - ball.pos.y : (ball.pos.y - r) + (contactY - r);
+    float x = ball.pos.x + ball.vel.x * (dist / fabsf(vy));
+
+    // Dobra x no intervalo entre as paredes (período de duas travessias)
+    float span = SCREEN_W - 2.0f * r;
+    float period = 2.0f * span;
+    float u = x - r;
+    float k = u * (1.0f / period);
+    float whole = (float)(int)k;            // floor sem chamada de biblioteca
+    if (whole > k) whole -= 1.0f;
+    u -= period * whole;
+    if (u > span) u = period - u;
+    return u + r;
+}
+
+void linear_features(Rectangle paddle, Ball ball, float *phi) {
+    memset(phi, 0, LINEAR_FEATURES * sizeof(float));
+    float center = paddle.x + PADDLE_W / 2.0f;
+    float landing = PredictLanding(paddle, ball);
+
+    // Escalas como multiplicações por constantes (sem divisões no passo)
+    const float invW = 1.0f / SCREEN_W, invH = 1.0f / SCREEN_H, invV = 1.0f / LINEAR_SPEED_SCALE;
+    phi[0] = 1.0f;
+    phi[1] = center * invW;
+    phi[2] = ball.pos.x * invW;
+    phi[3] = ball.pos.y * invH;
+    phi[4] = ball.vel.x * invV;
+    phi[5] = ball.vel.y * invV;
+    phi[6] = landing * invW;
+    phi[7] = (landing - center) * invW;
+    HatTiles(phi + 8, LINEAR_TILES_LAND, (landing - center) * (2.0f * invW));
+    HatTiles(phi + 8 + LINEAR_TILES_LAND, LINEAR_TILES_BALL, (ball.pos.x - center) * (2.0f * invW));
+}
+
+/* ---------- Valores e atualização ---------- */
+
+void linear_values(const LinearQ *L, const float *phi, float *q) {
+    ValuesImpl(L, phi, q);
+}
+
+int linear_choose_action(const LinearQ *L, const float *phi, float epsilon, Rng *rng) {
+    if (rng_float(rng) < epsilon) return rng_range(rng, 0, N_ACTIONS - 1);
+    float q[N_ACTIONS];
+    ValuesImpl(L, phi, q);
+    return argmax(q, N_ACTIONS);
+}
+
+float linear_update(LinearQ *L, const float *phi, int action, float target, float alpha) {
+    float q[N_ACTIONS];
+    ValuesImpl(L, phi, q);
+    float td = target - q[action];
+    // Normalizado por φ·φ: o passo não depende de quantas features acendem
+    float norm = NormImpl(phi);
+    if (norm > 0.0f) AxpyImpl(L->w[action], phi, alpha * td / norm);
+    return td;
+}
+
+/* ---------- Arquivo ---------- */
+
+// Cabeçalho do arquivo de pesos (16 bytes, endianness nativa)
+typedef struct {
+    char magic[8];          // LINEAR_MAGIC
+    uint16_t features;      // LINEAR_FEATURES
+    uint16_t actions;       // N_ACTIONS
+    uint32_t reserved;
+} LinearFileHeader;
+
+bool linear_save(const LinearQ *L, const char *filename) {
+    LinearFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, LINEAR_MAGIC, sizeof(LINEAR_MAGIC));
+    h.features = LINEAR_FEATURES;
+    h.actions = N_ACTIONS;
+
+    FILE *file = fopen(filename, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1 && fwrite(L->w, sizeof(L->w), 1, file) == 1;
+    return (fclose(file) == 0) && ok;
+}
+
+bool linear_load(LinearQ *L, const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+    LinearFileHeader h;
+    linear_init(L);
+    bool ok = fread(&h, sizeof(h), 1, file) == 1
+           && memcmp(h.magic, LINEAR_MAGIC, sizeof(LINEAR_MAGIC)) == 0
+           && h.features == LINEAR_FEATURES && h.actions == N_ACTIONS
+           && fread(L->w, sizeof(L->w), 1, file) == 1;
+    fclose(file);
+    if (!ok) memset(L->w, 0, sizeof(L->w));
+    return ok;
+}
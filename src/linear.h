@@ -0,0 +1,109 @@
+#ifndef LINEAR_H
+#define LINEAR_H
+
+#include "defs.h"
+#include "bot.h"
+#include "rng.h"
+#include <stdbool.h>
+
+/*
+ * Agente de aproximação linear: Q(s,a) = w[a] · φ(s), com φ calculado
+ * direto da bola e do paddle (sem discretizar). As features são contínuas
+ * (posições, velocidades, x previsto de chegada da bola ao paddle) mais
+ * blocos de tiles triangulares (cada valor acende dois tiles vizinhos, com
+ * pesos que somam 1) sobre a distância entre o paddle e a bola/ponto de
+ * chegada, o que permite generalizar entre posições vizinhas. Os pesos cabem
+ * em N_ACTIONS * LINEAR_FEATURES floats (menos de 1 KB).
+ *
+ * Produtos escalares e atualizações usam AVX2+FMA quando a CPU tem (escolha
+ * em tempo de execução), com uma versão escalar equivalente como reserva.
+ * Várias threads podem treinar os mesmos pesos sem locks (estilo Hogwild!).
+ */
+
+#define LINEAR_FEATURES 32      // múltiplo de 8 (uma carga AVX2)
+#define LINEAR_TILES_LAND 16    // tiles sobre (x previsto - centro do paddle)
+#define LINEAR_TILES_BALL 8     // tiles sobre (x da bola - centro do paddle)
+
+#define LINEAR_MAGIC "ARKLIN1"  // 7 caracteres + '\0'
+
+// Implementação dos produtos escalares
+#define LINEAR_ISA_SCALAR 0
+#define LINEAR_ISA_AVX2   1
+
+typedef struct {
+    float w[N_ACTIONS][LINEAR_FEATURES] __attribute__((aligned(32)));
+} LinearQ;
+
+/**
+ * Zera os pesos e escolhe a implementação (AVX2 se a CPU tiver).
+ * @param L Pesos.
+ */
+void linear_init(LinearQ *L);
+
+/**
+ * Força uma implementação (benchmarks). Pedir AVX2 sem suporte não muda nada.
+ * @param isa LINEAR_ISA_*.
+ * @return Implementação em uso depois da chamada.
+ */
+int linear_set_isa(int isa);
+
+/**
+ * Nome da implementação em uso ("avx2" ou "scalar").
+ */
+const char *linear_isa_name(void);
+
+/**
+ * Calcula as features de um estado.
+ * @param paddle Paddle.
+ * @param ball Bola.
+ * @param phi Saída com LINEAR_FEATURES floats, alinhada a 32 bytes.
+ */
+void linear_features(Rectangle paddle, Ball ball, float *phi);
+
+/**
+ * Valores Q de todas as ações para as features dadas.
+ * @param L Pesos.
+ * @param phi Features (alinhadas a 32 bytes).
+ * @param q Saída com N_ACTIONS valores.
+ */
+void linear_values(const LinearQ *L, const float *phi, float *q);
+
+/**
+ * Escolhe uma ação ε-greedy.
+ * @param L Pesos.
+ * @param phi Features do estado.
+ * @param epsilon Probabilidade de exploração.
+ * @param rng Gerador do agente.
+ * @return Ação escolhida.
+ */
+int linear_choose_action(const LinearQ *L, const float *phi, float epsilon, Rng *rng);
+
+/**
+ * Passo de gradiente semi-TD normalizado: w[a] += alpha * δ * φ / (φ·φ),
+ * com δ = target - w[a]·φ.
+ * @param L Pesos.
+ * @param phi Features do estado em que a ação foi tomada.
+ * @param action Ação tomada.
+ * @param target Alvo TD (recompensa + gamma * max Q do próximo estado).
+ * @param alpha Taxa de aprendizado.
+ * @return Erro TD δ.
+ */
+float linear_update(LinearQ *L, const float *phi, int action, float target, float alpha);
+
+/**
+ * Salva os pesos em arquivo binário.
+ * @param L Pesos.
+ * @param filename Caminho.
+ * @return true se salvou.
+ */
+bool linear_save(const LinearQ *L, const char *filename);
+
+/**
+ * Carrega pesos salvos por linear_save.
+ * @param L Pesos (a implementação é escolhida como em linear_init).
+ * @param filename Caminho.
+ * @return true se o arquivo é válido e compatível.
+ */
+bool linear_load(LinearQ *L, const char *filename);
+
+#endif // LINEAR_H
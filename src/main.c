@@ -5,293 +5,629 @@
 
 #include "raylib.h"
 #include "defs.h"
-#include "brick.h"
+#include "level.h"
 #include "sound.h"
 #include "bot.h"
+#include "sim.h"
+#include "train.h"
+#include "qtable_io.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "render.h"
+#include "simthread.h"
+#include "actionlog.h"
+#include "playback.h"
+#include "policy.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
 #include <assert.h>
+#include <string.h>
 #include <time.h>
 
-// Parâmetros do Q-Learning
-#define ALPHA 0.1f      // Taxa de aprendizado
-#define GAMMA 0.95f     // Fator de desconto
-#define EPSILON 0.1f    // Taxa de exploração inicial
-#define EPSILON_DECAY 0.995f  // Decaimento do epsilon
-#define MIN_EPSILON 0.01f     // Epsilon mínimo
+// Limite de tempo acumulado por frame (evita espiral após travadas)
+#define MAX_FRAME_TIME 0.25f
+
+// Checkpoint do treino na janela: arquivo padrão e episódios entre gravações
+#define CHECKPOINT_PATH "arkanoid.ckpt"
+#define CHECKPOINT_EVERY 100
+
+// Episódios por linha de score médio no terminal
+#define REPORT_EVERY 100
+
+// Trace de --trace quando nenhum caminho é dado (F4 grava a qualquer momento)
+#define TRACE_PATH "arkanoid_trace.json"
+
+// Quadros entre atualizações do overlay de tempos
+#define PROFILE_OVERLAY_EVERY 15
+
+// Reprodução: segundos antes da derrota mostrados ao abrir (e com END) e
+// arquivo gravado com F5
+#define REPLAY_TAIL_SECONDS 5.0f
+#define REPLAY_PATH "arkanoid_replay.log"
+
+// Barra de progresso da reprodução (clicar ou arrastar navega)
+#define REPLAY_BAR_H 6
+
+// Zonas de tempo do loop principal
+enum {
+    ZONE_FRAME,     // quadro inteiro
+    ZONE_INPUT,     // teclado, troca de modo
+    ZONE_RESET,     // fim de episódio: reinício (level_reset) e checkpoint
+    ZONE_SIM,       // passos da simulação no modo humano
+    ZONE_BOT,       // passos do bot (estado, ação, simulação, atualização da Q-table)
+    ZONE_AUDIO,     // fila de sons do quadro (PlayQueuedSounds)
+    ZONE_DRAW,      // comandos de desenho
+    ZONE_PRESENT,   // EndDrawing (envio à GPU e espera do vsync)
+    ZONE_COUNT
+};
+
+static const char *const zoneNames[ZONE_COUNT] = {
+    "frame", "input", "reset", "sim", "bot", "audio", "draw", "present"
+};
 
 // Modos de jogo
 typedef enum {
     MODE_HUMAN,     // Jogador humano
     MODE_TRAINING,  // Bot em treinamento
-    MODE_AI_PLAY    // Bot jogando (sem exploração)
+    MODE_AI_PLAY,   // Bot jogando (sem exploração)
+    MODE_FAST_TRAINING, // Treino em thread própria, sem limite de velocidade
+    MODE_REPLAY     // Revendo o último episódio perdido pelo bot (ou --replay)
 } GameMode;
 
-static void CreatePaddle(Rectangle* paddle) {
-    paddle->x = (SCREEN_W - PADDLE_W) / 2.0f;
-    paddle->y = SCREEN_H - 40;
-    paddle->width  = PADDLE_W;
-    paddle->height = PADDLE_H;
+// Velocidades da reprodução (setas para cima/baixo)
+static const int replaySpeeds[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+#define REPLAY_SPEED_COUNT ((int)(sizeof(replaySpeeds) / sizeof(replaySpeeds[0])))
+
+// Rótulos da camada de textos
+enum {
+    LABEL_SCORE,
+    LABEL_MODE,
+    LABEL_HELP,
+    LABEL_GAME_OVER
+};
+
+// Valores mostrados na interface; os rótulos só são refeitos quando mudam
+typedef struct {
+    int score;
+    int episode;
+    float epsilon;
+    GameMode mode;
+    bool gameOver;
+    bool realtime;      // treino rápido em tempo real
+    int speed;          // velocidade da reprodução
+    bool paused;        // reprodução pausada
+    bool policy;        // a IA joga pela política compilada (--policy)
+} UiState;
+
+static void UpdateLabels(TextLayer *text, UiState *shown, const UiState *now) {
+    if (now->score != shown->score) {
+        SetTextLabel(text, LABEL_SCORE, TextFormat("SCORE: %05i", now->score), 10, 10, 20, RAYWHITE);
+    }
+    if (now->mode != shown->mode || now->episode != shown->episode || now->epsilon != shown->epsilon
+        || now->realtime != shown->realtime || now->speed != shown->speed || now->paused != shown->paused) {
+        const char *modeText = "";
+        if (now->mode == MODE_HUMAN) modeText = "HUMANO [1]";
+        else if (now->mode == MODE_TRAINING) modeText = TextFormat("TREINANDO [2] - Ep:%d E:%.3f", now->episode, now->epsilon);
+        else if (now->mode == MODE_AI_PLAY) modeText = now->policy ? "IA JOGANDO [3] - política" : "IA JOGANDO [3]";
+        else if (now->mode == MODE_FAST_TRAINING)
+            modeText = TextFormat("TREINO RÁPIDO [4] - Ep:%d E:%.3f%s", now->episode, now->epsilon,
+                                  now->realtime ? " (tempo real, R)" : " (R: tempo real)");
+        else if (now->mode == MODE_REPLAY)
+            modeText = TextFormat("REPLAY [5] - %dx%s", now->speed, now->paused ? " (pausado)" : "");
+        SetTextLabel(text, LABEL_MODE, modeText, 10, 35, 16, LIME);
+    }
+    if (now->mode != shown->mode) {
+        const char *helpText = now->mode == MODE_REPLAY
+            ? "SPACE pausa  ESQ/DIR 1 s  CIMA/BAIXO velocidade  HOME/END  F5 salva"
+            : "1-Humano 2-Treinar 3-IA 4-Treino rápido 5-Replay";
+        SetTextLabel(text, LABEL_HELP, helpText, 10, SCREEN_H - 25, 14, GRAY);
+    }
+    if (now->mode != shown->mode || now->gameOver != shown->gameOver) {
+        const char *overText = "";
+        if (now->gameOver) {
+            if (now->mode == MODE_HUMAN) overText = "GAME OVER — SPACE para reiniciar";
+            else if (now->mode == MODE_REPLAY) overText = "FIM DO EPISÓDIO — HOME ou END para rever";
+            else overText = "GAME OVER — Reiniciando...";
+        }
+        SetTextLabel(text, LABEL_GAME_OVER, overText, UI_CENTER, SCREEN_H / 2 - 10, 20, RED);
+    }
+    *shown = *now;
 }
 
-static void CreateBall(Ball* ball) {
-    ball->pos = (Vector2) { SCREEN_W / 2.0f, SCREEN_H / 2.0f };
-    ball->vel = (Vector2) { GetRandomValue(-240, 240), -240 };   // px/s
-    ball->radius = BALL_R;
+// Começa um episódio novo; com record, as ações dele são gravadas em log
+static void Reinit(SimState *sim, ActionLog *log, bool record) {
+    QueueSound(SFX_RESTART);
+    if (record) actionlog_begin(log, sim);
+    sim_reset(sim);
 }
 
-static int ClampInt(int value, int min, int max)  {
-    if (value < min ) return min;
-    if (value > max ) return max;
-    return value;
+// Enfileira os sons correspondentes aos eventos de um passo da simulação
+static void QueueEventSounds(unsigned events) {
+    if (events & SIM_EVENT_PADDLE_HIT) QueueSound(SFX_PADDLE_HIT);
+    if (events & SIM_EVENT_BRICK_HIT)  QueueSound(SFX_BRICK_HIT);
+    if (events & SIM_EVENT_GAME_OVER) {
+        // QueueSound(SFX_GAME_OVER);
+    }
 }
 
-static void Reinit(Ball* ball, Rectangle* paddle, Brick bricks[ROWS][COLS], int *score, bool *gameOver) {
-    PlaySound(restartSound);
-    CreateBall(ball);
-    CreatePaddle(paddle);
-    InitBricks(bricks);
-    *score = 0;
-    *gameOver = false;
+// Tabela min/média/p99 por zona (ms), atualizada a cada PROFILE_OVERLAY_EVERY quadros
+static void DrawProfileOverlay(const ProfStats *stats) {
+    const int x = SCREEN_W - 250, y = 40, rowH = 14;
+    DrawRectangle(x - 6, y - 4, 246, (ZONE_COUNT + 1) * rowH + 8, Fade(BLACK, 0.75f));
+    DrawText("zona        min    med    p99 (ms)", x, y, 10, GRAY);
+    for (int z = 0; z < ZONE_COUNT; z++) {
+        DrawText(TextFormat("%-9s %6.3f %6.3f %6.3f", zoneNames[z], stats[z].min, stats[z].avg, stats[z].p99),
+                 x, y + (z + 1) * rowH, 10, z == ZONE_FRAME ? YELLOW : RAYWHITE);
+    }
 }
 
-static void DrawBorders(void) {
-    DrawRectangle(0, 0, SCREEN_W, 4, WHITE); // Topo
-    DrawRectangle(0, SCREEN_H - 4, SCREEN_W, 4, WHITE); // Base
-    DrawRectangle(0, 0, 4, SCREEN_H, WHITE); // Esquerda
-    DrawRectangle(SCREEN_W - 4, 0, 4, SCREEN_H, WHITE); // Direita
+// Barra de progresso da reprodução, com a marca dos últimos REPLAY_TAIL_SECONDS
+static void DrawReplayBar(const Playback *pb) {
+    long count = pb->log->count > 0 ? pb->log->count : 1;
+    float dt = pb->sim.dt;
+    float tail = 1.0f - REPLAY_TAIL_SECONDS / (count * dt);
+    DrawRectangle(0, SCREEN_H - REPLAY_BAR_H, SCREEN_W, REPLAY_BAR_H, DARKGRAY);
+    DrawRectangle(0, SCREEN_H - REPLAY_BAR_H, (int)((float)pb->step / count * SCREEN_W), REPLAY_BAR_H, ORANGE);
+    if (tail > 0.0f) DrawRectangle((int)(tail * SCREEN_W), SCREEN_H - REPLAY_BAR_H, 2, REPLAY_BAR_H, RED);
+    DrawText(TextFormat("%.1f / %.1f s", pb->step * dt, pb->log->count * dt), SCREEN_W - 130, SCREEN_H - 25, 14, GRAY);
 }
 
-// Calcula a recompensa baseada no estado atual do jogo
-float CalculateReward(Ball ball, Rectangle paddle, int score, int lastScore, bool gameOver, bool hitBrick) {
-    float reward = 0.0f;
-    
-    if (gameOver) {
-        reward = -100.0f;  // Penalidade por perder
-    } else if (hitBrick) {
-        reward = 50.0f;    // Recompensa por quebrar tijolo
-    } else if (score > lastScore) {
-        reward = 10.0f;    // Recompensa por aumentar score
-    } else {
-        // Recompensa baseada na proximidade da bola com o paddle
-        float distance = fabsf(ball.pos.x - (paddle.x + PADDLE_W/2));
-        float normalized_distance = distance / (SCREEN_W/2);
-        reward = 1.0f - normalized_distance;  // Quanto mais próximo, maior a recompensa
-    }
-    
-    return reward;
+// Grava o estado do treino em segundo plano (wait = true bloqueia até poder enviar)
+static void SubmitCheckpoint(Checkpointer *ck, const QTable *Q, const TrainParams *params, float epsilon,
+                             int episode, long steps, uint64_t seed, uint64_t simRng, const Rng *botRng, bool wait) {
+    QTableMeta meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.alpha = params->alpha;
+    meta.gamma = params->gamma;
+    meta.epsilon = epsilon;
+    meta.episodes = episode;
+    meta.steps = steps;
+    meta.seed = seed;
+    meta.simRng = simRng;
+    meta.agentRng = botRng->state;
+    checkpoint_submit(ck, Q, &meta, wait);
 }
 
-// Executa a ação escolhida pelo bot
-void ExecuteAction(Rectangle* paddle, int action, float dt) {
-    float speed = 450.0f;
-    
-    switch(action) {
-        case 0: // Mover para esquerda
-            paddle->x -= speed * dt;
-            break;
-        case 1: // Ficar parado
-            // Não faz nada
-            break;
-        case 2: // Mover para direita
-            paddle->x += speed * dt;
-            break;
+int main(int argc, char **argv) {
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *checkpointPath = CHECKPOINT_PATH;
+    bool resume = false;
+    bool checkpointGiven = false;   // --checkpoint explícito
+    const char *telemetryPath = NULL;
+    const char *tracePath = NULL;
+    const char *levelPath = NULL;
+    const char *replayPath = NULL;
+    const char *policyPath = NULL;
+    bool mute = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--resume") == 0) resume = true;
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpointPath = argv[++i];
+            checkpointGiven = true;
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) telemetryPath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) levelPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) policyPath = argv[++i];
+        else if (strcmp(argv[i], "--mute") == 0) mute = true;
+    }
+
+    Level level;
+    char levelErr[256];
+    if (levelPath && !level_load(&level, levelPath, levelErr, sizeof(levelErr))) {
+        printf("Nível inválido: %s\n", levelErr);
+        return 1;
+    }
+
+    // Episódios do bot: o atual grava em `recording` e, ao perder, troca de
+    // lugar com `lastLoss` (os dois buffers são reaproveitados)
+    ActionLog recording, lastLoss;
+    memset(&recording, 0, sizeof(recording));
+    memset(&lastLoss, 0, sizeof(lastLoss));
+    bool haveLoss = false;
+    if (replayPath) {
+        if (!actionlog_load(&lastLoss, replayPath)) {
+            printf("Registro inválido: %s\n", replayPath);
+            return 1;
+        }
+        if (!actionlog_level_matches(&lastLoss, levelPath ? &level : NULL)) {
+            printf("%s foi gravado em outro nível (use o mesmo --level da gravação)\n", replayPath);
+            actionlog_free(&lastLoss);
+            return 1;
+        }
+        haveLoss = true;
     }
-    
-    // Manter paddle dentro da tela
-    paddle->x = ClampInt(paddle->x, 0, SCREEN_W - PADDLE_W);
-}
 
-int main(void) {
-    srand(time(NULL));
+    // Política compilada: com ela o modo IA joga sem ler a Q-table
+    Policy policy;
+    if (policyPath && !policy_load(&policy, policyPath)) {
+        printf("Política inválida ou incompatível: %s\n", policyPath);
+        return 1;
+    }
     
     SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(SCREEN_W, SCREEN_H, "Arkanoid — Q-Learning Bot");
     
     // Inicializar áudio
-    InitAudioDevice();
-    LoadSounds();
-
-    // Inicializar Q-Learning
-    float **Q = init_q_table();
-    float epsilon = EPSILON;
-    int episode = 0;
-    int totalScore = 0;
-    
-    // Estados para Q-Learning
-    int currentState, nextState;
-    int currentAction;
-    bool firstStep = true;
+    LoadSounds(!mute);    // o dispositivo de áudio abre no primeiro som
+
+    // Inicializar Q-Learning; com --policy a janela só joga e a Q-table
+    // nem é alocada
+    const TrainParams params = TRAIN_PARAMS_DEFAULT;
+    QTableMeta resumed;
+    QTable *Q = NULL;
+    if (policyPath && resume) printf("Com --policy não há treino: --resume ignorado\n");
+    else if (resume) {
+        Q = map_qtable(checkpointPath, &resumed, true);
+        if (!Q) printf("Checkpoint %s ausente ou inválido: começando do zero\n", checkpointPath);
+    }
+    bool haveResume = (Q != NULL);
+    if (haveResume) seed = resumed.seed;
+    else if (!policyPath) Q = init_q_table(NULL);
+    float epsilon = haveResume ? resumed.epsilon : params.epsilon;
+    Rng botRng;
+    rng_seed(&botRng, rng_agent_seed(seed, 0));
+    int episode = haveResume ? (int)resumed.episodes : 0;   // episódios de treino
+    long trainSteps = haveResume ? (long)resumed.steps : 0; // passos de treino
     
     // Game objects
-    Rectangle paddle;
-    CreatePaddle(&paddle);
-    
-    Ball ball;
-    CreateBall(&ball);
-    
-    Brick bricks[ROWS][COLS];
-    InitBricks(bricks);
-
-    // States
-    int score = 0, lastScore = 0;
-    bool gameOver = false;
-    bool hitBrick = false;
-    GameMode mode = MODE_TRAINING;  // Começar em modo de treinamento
+    SimState sim;
+    sim_init(&sim, SIM_DT, rng_env_seed(seed, 0));
+    if (levelPath) sim_set_level(&sim, &level);
+    if (haveResume) {
+        // Checkpoints guardam o gerador de antes do lançamento da bola: um só
+        // sim_reset sorteia a mesma bola do treino original (como o
+        // train_episode do headless). Checkpoints antigos gravavam 0, que
+        // travaria o xorshift: fica a semente.
+        if (resumed.simRng) sim.rng.state = resumed.simRng;
+        if (resumed.agentRng) botRng.state = resumed.agentRng;
+        sim_reset(&sim);
+    }
+
+    // Um checkpoint existente só é substituído se foi retomado ou escolhido com
+    // --checkpoint; o gravador só liga quando algum treino roda
+    bool mayCheckpoint = !policyPath && (haveResume || checkpointGiven || !FileExists(checkpointPath));
+    if (!policyPath && !mayCheckpoint) printf("%s já existe: treino sem checkpoints (use --resume ou --checkpoint ARQ)\n", checkpointPath);
+    Checkpointer ck;
+    bool checkpointing = false;
+    bool trained = false;
+    float accumulator = 0.0f;
+
+    Telemetry telemetry;
+    bool telemetryOn = telemetryPath && telemetry_start(&telemetry, telemetryPath, 1, TELEMETRY_DEFAULT_INTERVAL);
+    if (telemetryPath && !telemetryOn) printf("Falha ao iniciar a telemetria em %s\n", telemetryPath);
+    TrainEpisodeStats episodeStats;
+    memset(&episodeStats, 0, sizeof(episodeStats));
+
+    GameMode mode = policyPath ? MODE_AI_PLAY : MODE_TRAINING;  // Começar treinando (ou jogando a política)
+
+    // Média de score: só episódios do modo atual (a janela recomeça ao trocar)
+    GameMode windowMode = mode;
+    if (replayPath) mode = MODE_REPLAY;     // abre no primeiro quadro
+    int windowEpisodes = 0;
+    int windowScore = 0;
+
+    // Tempos por zona; F3 mostra o overlay e F4 grava o trace
+    Profiler prof;
+    bool profiling = prof_init(&prof, zoneNames, ZONE_COUNT);
+    bool showProfile = false;
+    ProfStats zoneStats[ZONE_COUNT];
+    memset(zoneStats, 0, sizeof(zoneStats));
+
+    // Tijolos, bordas e textos em texturas refeitas só quando mudam
+    BrickLayer brickLayer;
+    InitBrickLayer(&brickLayer);
+    TextLayer textLayer;
+    InitTextLayer(&textLayer);
+    UiState shown = { -1, -1, -1.0f, (GameMode)-1, false, false, 0, false, false };
+    UiState ui = { 0, 0, 0.0f, MODE_HUMAN, false, false, 0, false, false };
+
+    // Treino rápido: a thread publica retratos e o desenho interpola os dois últimos
+    SimThread fast;
+    memset(&fast, 0, sizeof(fast));
+    SimSnapshot prevShot, currShot, view;
+    memset(&prevShot, 0, sizeof(prevShot));
+    memset(&currShot, 0, sizeof(currShot));
+
+    // Reprodução do episódio em lastLoss
+    Playback playback;
+    memset(&playback, 0, sizeof(playback));
+    int replaySpeed = 0;        // índice em replaySpeeds
+    bool replayPaused = false;
+    float replayClock = 0.0f;   // tempo de jogo ainda não simulado
     
     SetTargetFPS(60);
 
     while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
+        uint64_t frameZone = prof_begin();
+        uint64_t zone = frameZone;
+        float frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+        accumulator += frameTime;
 
         /* ---------- Controles de Modo ---------- */
         if (IsKeyPressed(KEY_ONE)) mode = MODE_HUMAN;
-        if (IsKeyPressed(KEY_TWO)) mode = MODE_TRAINING;
+        if (IsKeyPressed(KEY_TWO) || IsKeyPressed(KEY_FOUR)) {
+            if (!Q) printf("Com --policy não há Q-table para treinar\n");
+            else mode = IsKeyPressed(KEY_TWO) ? MODE_TRAINING : MODE_FAST_TRAINING;
+        }
         if (IsKeyPressed(KEY_THREE)) mode = MODE_AI_PLAY;
+        if (IsKeyPressed(KEY_FIVE)) {
+            if (haveLoss) mode = MODE_REPLAY;
+            else printf("Nenhum episódio perdido para rever\n");
+        }
+        if (mode == MODE_FAST_TRAINING && IsKeyPressed(KEY_R)) simthread_set_realtime(&fast, !fast.realtime);
+        if (!trained && (mode == MODE_TRAINING || mode == MODE_FAST_TRAINING)) {
+            trained = true;
+            checkpointing = mayCheckpoint && checkpoint_start(&ck, checkpointPath, Q->spec);
+        }
+        if (mode != windowMode) {
+            // Só se grava episódio inteiro: o atual fica sem gravação
+            sim.log = NULL;
+            if (windowMode == MODE_REPLAY) playback_free(&playback);
+            if (windowMode == MODE_FAST_TRAINING) {
+                // Devolve simulação e Q-table ao loop da janela
+                simthread_stop(&fast);
+                epsilon = fast.epsilon;
+                episode = (int)fast.episode;
+                trainSteps = fast.trainSteps;
+            }
+            if (mode == MODE_FAST_TRAINING) {
+                fast.Q = Q;
+                fast.sim = &sim;
+                fast.rng = &botRng;
+                fast.params = params;
+                fast.epsilon = epsilon;
+                fast.episode = episode;
+                fast.trainSteps = trainSteps;
+                fast.seed = seed;
+                fast.checkpoint = checkpointing ? &ck : NULL;
+                fast.checkpointEvery = CHECKPOINT_EVERY;
+                fast.telemetry = telemetryOn ? telemetry_slot(&telemetry, 0) : NULL;
+                if (simthread_start(&fast)) {
+                    snapshot_copy(&currShot, snapshot_latest(&fast.snapshots));
+                    snapshot_copy(&prevShot, &currShot);
+                } else {
+                    printf("Falha ao iniciar a thread de treino\n");
+                    mode = MODE_TRAINING;
+                }
+            }
+            if (mode == MODE_REPLAY) {
+                if (playback_open(&playback, &lastLoss, sim.level)) {
+                    // Começa pelos últimos segundos antes da derrota
+                    playback_seek(&playback, lastLoss.count - (long)(REPLAY_TAIL_SECONDS / playback.sim.dt));
+                    replaySpeed = 0;
+                    replayPaused = false;
+                    replayClock = 0.0f;
+                } else {
+                    printf("Falha ao abrir a reprodução\n");
+                    mode = Q ? MODE_TRAINING : MODE_AI_PLAY;
+                }
+            }
+            windowMode = mode;
+            windowEpisodes = 0;
+            windowScore = 0;
+            memset(&episodeStats, 0, sizeof(episodeStats));
+        }
+        if (mode == MODE_REPLAY) {
+            long second = (long)(1.0f / playback.sim.dt + 0.5f);   // passos por segundo de jogo
+            if (IsKeyPressed(KEY_SPACE)) replayPaused = !replayPaused;
+            if (IsKeyPressed(KEY_UP) && replaySpeed < REPLAY_SPEED_COUNT - 1) replaySpeed++;
+            if (IsKeyPressed(KEY_DOWN) && replaySpeed > 0) replaySpeed--;
+            if (IsKeyPressed(KEY_LEFT)) playback_seek(&playback, playback.step - second);
+            if (IsKeyPressed(KEY_RIGHT)) playback_seek(&playback, playback.step + second);
+            if (IsKeyPressed(KEY_HOME)) playback_seek(&playback, 0);
+            if (IsKeyPressed(KEY_END))
+                playback_seek(&playback, lastLoss.count - (long)(REPLAY_TAIL_SECONDS * second));
+            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && GetMouseY() >= SCREEN_H - 4 * REPLAY_BAR_H)
+                playback_seek(&playback, (long)((float)GetMouseX() / SCREEN_W * lastLoss.count));
+        }
+        if (haveLoss && IsKeyPressed(KEY_F5)) {
+            if (actionlog_save(&lastLoss, REPLAY_PATH)) printf("Episódio gravado em %s (%ld passos)\n", REPLAY_PATH, lastLoss.count);
+            else printf("Falha ao gravar o episódio em %s\n", REPLAY_PATH);
+        }
+        if (IsKeyPressed(KEY_F3)) showProfile = !showProfile;
+        if (profiling && IsKeyPressed(KEY_F4)) {
+            const char *path = tracePath ? tracePath : TRACE_PATH;
+            if (prof_export_trace(&prof, path)) printf("Trace gravado em %s\n", path);
+        }
+        if (profiling) prof_end(&prof, ZONE_INPUT, zone);
         
         /* ---------- Lógica ---------- */
         // Reiniciar
-        if (gameOver) {
+        zone = prof_begin();
+        if (mode != MODE_FAST_TRAINING && mode != MODE_REPLAY && sim.gameOver) {
             if (mode == MODE_HUMAN && IsKeyPressed(KEY_SPACE)) {
-                Reinit(&ball, &paddle, bricks, &score, &gameOver);
-                firstStep = true;
+                Reinit(&sim, &recording, false);
             } else if (mode != MODE_HUMAN) {
                 // Auto-reiniciar para treinamento/AI
-                episode++;
-                totalScore += score;
-                
-                if (episode % 100 == 0) {
-                    printf("Episódio %d - Score médio: %.2f - Epsilon: %.3f\n", episode, (float)totalScore/100, epsilon);
-                    totalScore = 0;
+                windowEpisodes++;
+                windowScore += sim.score;
+                if (mode == MODE_TRAINING) {
+                    episode++;
+                    if (telemetryOn) telemetry_episode(telemetry_slot(&telemetry, 0), &episodeStats, sim.score, epsilon);
+                }
+                memset(&episodeStats, 0, sizeof(episodeStats));
+                if (sim.log) {
+                    // Guarda a derrota para o replay; o buffer antigo grava o próximo episódio
+                    actionlog_end(&recording, &sim);
+                    ActionLog done = lastLoss;
+                    lastLoss = recording;
+                    recording = done;
+                    haveLoss = true;
+                }
+
+                if (windowEpisodes == REPORT_EVERY) {
+                    if (mode == MODE_TRAINING)
+                        printf("Episódio %d - Score médio: %.2f - Epsilon: %.3f\n", episode, (float)windowScore/windowEpisodes, epsilon);
+                    else
+                        printf("IA jogando - Score médio: %.2f em %d jogos\n", (float)windowScore/windowEpisodes, windowEpisodes);
+                    windowEpisodes = 0;
+                    windowScore = 0;
                 }
                 
-                Reinit(&ball, &paddle, bricks, &score, &gameOver);
-                firstStep = true;
+                uint64_t launchRng = sim.rng.state;    // gerador antes de sortear a bola nova
+                Reinit(&sim, &recording, true);
                 
                 // Decaimento do epsilon durante treinamento
-                if (mode == MODE_TRAINING && epsilon > MIN_EPSILON) {
-                    epsilon *= EPSILON_DECAY;
+                if (mode == MODE_TRAINING) {
+                    epsilon = train_decay_epsilon(&params, epsilon);
+                    if (checkpointing && episode % CHECKPOINT_EVERY == 0) {
+                        SubmitCheckpoint(&ck, Q, &params, epsilon, episode, trainSteps, seed, launchRng, &botRng, false);
+                    }
                 }
             }
         }
+        if (profiling) prof_end(&prof, ZONE_RESET, zone);
+
+        // Entrada do jogador humano, aplicada a todos os passos deste frame
+        int humanAction = ACTION_STAY;
+        if (mode == MODE_HUMAN) {
+            // As duas setas juntas se anulam, como no controle original
+            if (IsKeyDown(KEY_LEFT))  humanAction -= 1;
+            if (IsKeyDown(KEY_RIGHT)) humanAction += 1;
+            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+                sim.paddle.x = GetMouseX() - PADDLE_W / 2.0f;
+                ExecuteAction(&sim.paddle, ACTION_STAY, 0.0f);   // só limita à tela
+            }
+        }
+
+        // Reprodução: speed passos de jogo por passo de tempo real
+        if (mode == MODE_REPLAY) {
+            zone = prof_begin();
+            if (!replayPaused) replayClock += frameTime * replaySpeeds[replaySpeed];
+            long steps = (long)(replayClock / playback.sim.dt);
+            replayClock -= steps * playback.sim.dt;
+            unsigned events = playback_advance(&playback, steps);
+            if (events) QueueEventSounds(events);
+            if (profiling) prof_end(&prof, ZONE_SIM, zone);
+        }
 
-        if (!gameOver) {
-            // Movimento do paddle baseado no modo
+        // Passos fixos da simulação
+        if (mode == MODE_FAST_TRAINING || mode == MODE_REPLAY) accumulator = 0.0f;   // a thread ou a reprodução dão os passos
+        while (accumulator >= sim.dt) {
+            accumulator -= sim.dt;
+            if (sim.gameOver) continue;
+
+            unsigned events;
+            zone = prof_begin();
             if (mode == MODE_HUMAN) {
-                // Controle humano
-                if (IsKeyDown(KEY_LEFT))  paddle.x -= 450 * dt;
-                if (IsKeyDown(KEY_RIGHT)) paddle.x += 450 * dt;
-                if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
-                    paddle.x = GetMouseX() - PADDLE_W / 2.0f;
-                paddle.x = ClampInt(paddle.x, 0, SCREEN_W - PADDLE_W);
+                events = sim_step(&sim, humanAction);
+                if (profiling) prof_end(&prof, ZONE_SIM, zone);
+            } else if (mode == MODE_AI_PLAY && policyPath) {
+                // Só consulta a tabela de 2 bits: sem floats e sem aprendizado
+                events = policy_step(&policy, &sim);
+                if (profiling) prof_end(&prof, ZONE_BOT, zone);
             } else {
-                // Controle do bot (Q-Learning)
-                nextState = encode_state(paddle, ball);
-                
-                if (!firstStep) {
-                    // Calcular recompensa
-                    float reward = CalculateReward(ball, paddle, score, lastScore, gameOver, hitBrick);
-                    
-                    // Atualizar Q-table
-                    q_learning_update(Q, currentState, currentAction, reward, 
-                                    nextState, ALPHA, GAMMA, N_ACTIONS);
-                }
-                
-                // Escolher próxima ação
-                float currentEpsilon = (mode == MODE_TRAINING) ? epsilon : 0.0f; // Sem exploração no modo AI_PLAY
-                currentAction = choose_action(Q, nextState, currentEpsilon);
-                
-                // Executar ação
-                ExecuteAction(&paddle, currentAction, dt);
-                
-                currentState = nextState;
-                lastScore = score;
-                firstStep = false;
+                // Controle do bot (Q-Learning); sem exploração no modo AI_PLAY
+                float currentEpsilon = (mode == MODE_TRAINING) ? epsilon : 0.0f;
+                events = train_step(Q, &sim, currentEpsilon, params.alpha, params.gamma, &botRng, &episodeStats);
+                episodeStats.steps++;
+                if (mode == MODE_TRAINING) trainSteps++;
+                if (profiling) prof_end(&prof, ZONE_BOT, zone);
             }
+            if (events) QueueEventSounds(events);
+        }
 
-            // Movimento da bola
-            ball.pos.x += ball.vel.x * dt;
-            ball.pos.y += ball.vel.y * dt;
-
-            // Colisões com bordas
-            if (ball.pos.x <= ball.radius || ball.pos.x >= SCREEN_W - ball.radius)
-                ball.vel.x *= -1.0f;
-            if (ball.pos.y <= ball.radius)
-                ball.vel.y *= -1.0f;
-            if (ball.pos.y >= SCREEN_H + ball.radius) {
-                if (!gameOver) {
-                    // PlaySound(gameOverSound);
-                }
-                gameOver = true;
-            }
+        // Sons do quadro: um por tipo, com limite de vozes
+        zone = prof_begin();
+        PlayQueuedSounds();
+        if (profiling) prof_end(&prof, ZONE_AUDIO, zone);
 
-            // Colisão com paddle
-            if (CheckCollisionCircleRec(ball.pos, ball.radius, paddle)) {
-                PlaySound(paddleHitSound);
-                ball.vel.y = -fabsf(ball.vel.y);
-                float hit = (ball.pos.x - (paddle.x + PADDLE_W / 2.0f)) / (PADDLE_W / 2.0f);
-                ball.vel.x = 300 * hit;
+        /* ---------- Render ---------- */
+        zone = prof_begin();
+        if (mode == MODE_FAST_TRAINING) {
+            const SimSnapshot *latest = snapshot_latest(&fast.snapshots);
+            if (latest->seq != currShot.seq) {
+                snapshot_copy(&prevShot, &currShot);
+                snapshot_copy(&currShot, latest);
             }
-            
-            // Colisões com tijolos
-            hitBrick = false;
-            CreateBricks(bricks, &ball, &score);
-            if (score > lastScore) hitBrick = true;
+            // Um intervalo de atraso: vai do retrato anterior ao atual até o próximo chegar
+            double interval = currShot.time - prevShot.time;
+            float t = interval > 0.0 ? (float)((snapshot_now() - currShot.time) / interval) : 1.0f;
+            snapshot_lerp(&view, &prevShot, &currShot, t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t));
+        } else if (mode == MODE_REPLAY) {
+            snapshot_capture(&view, &playback.sim, episode, epsilon);
+        } else {
+            snapshot_capture(&view, &sim, episode, epsilon);
         }
+        ui.score = view.score;
+        ui.episode = (int)view.episode;
+        ui.epsilon = view.epsilon;
+        ui.mode = mode;
+        ui.gameOver = view.gameOver;
+        ui.realtime = fast.realtime;
+        ui.speed = replaySpeeds[replaySpeed];
+        ui.paused = replayPaused;
+        ui.policy = (policyPath != NULL);
+        UpdateLabels(&textLayer, &shown, &ui);
+        UpdateBrickLayer(&brickLayer, view.level, view.bricks);
+        UpdateTextLayer(&textLayer);
 
-        /* ---------- Render ---------- */
         BeginDrawing();
-            ClearBackground(BLACK);
-
-            DrawBorders();
-            DrawBricks(bricks);
+            DrawBrickLayer(&brickLayer);    // fundo, bordas e tijolos
             
             // Paddle colorido baseado no modo
             Color paddleColor = WHITE;
             if (mode == MODE_TRAINING) paddleColor = BLUE;
             else if (mode == MODE_AI_PLAY) paddleColor = GREEN;
+            else if (mode == MODE_FAST_TRAINING) paddleColor = SKYBLUE;
+            else if (mode == MODE_REPLAY) paddleColor = ORANGE;
             
-            DrawRectangleRounded(paddle, 0.6f, 10, paddleColor);
-            DrawCircleV(ball.pos, ball.radius, YELLOW);
+            DrawRectangleRounded(view.paddle, 0.6f, 10, paddleColor);
+            DrawCircleV(view.ball.pos, view.ball.radius, YELLOW);
 
             // UI
-            DrawText(TextFormat("SCORE: %05i", score), 10, 10, 20, RAYWHITE);
-            
-            // Informações do modo
-            const char* modeText = "";
-            if (mode == MODE_HUMAN) modeText = "HUMANO [1]";
-            else if (mode == MODE_TRAINING) modeText = TextFormat("TREINANDO [2] - Ep:%d E:%.3f", episode, epsilon);
-            else if (mode == MODE_AI_PLAY) modeText = "IA JOGANDO [3]";
-            
-            DrawText(modeText, 10, 35, 16, LIME);
-            DrawText("1-Humano 2-Treinar 3-IA", 10, SCREEN_H - 25, 14, GRAY);
-            
-            if (gameOver) {
-                if (mode == MODE_HUMAN) {
-                    DrawText("GAME OVER — SPACE para reiniciar",
-                        SCREEN_W / 2 - MeasureText("GAME OVER — SPACE para reiniciar", 20) / 2,
-                        SCREEN_H / 2 - 10, 20, RED);
-                } else {
-                    DrawText("GAME OVER — Reiniciando...",
-                        SCREEN_W / 2 - MeasureText("GAME OVER — Reiniciando...", 20) / 2,
-                        SCREEN_H / 2 - 10, 20, RED);
+            DrawTextLayer(&textLayer);
+            if (mode == MODE_REPLAY) DrawReplayBar(&playback);
+            DrawFPS(SCREEN_W - 90, 10);
+            if (profiling && showProfile) {
+                if (prof.frames % PROFILE_OVERLAY_EVERY == 0) {
+                    for (int z = 0; z < ZONE_COUNT; z++) prof_stats(&prof, z, &zoneStats[z]);
                 }
+                DrawProfileOverlay(zoneStats);
             }
-
-            DrawFPS(SCREEN_W - 90, 10);
+        if (profiling) prof_end(&prof, ZONE_DRAW, zone);
+        zone = prof_begin();
         EndDrawing();
+        if (profiling) {
+            prof_end(&prof, ZONE_PRESENT, zone);
+            prof_end(&prof, ZONE_FRAME, frameZone);
+            prof_frame_end(&prof);
+        }
     }
 
     // Limpeza
-    for (int i = 0; i < N_STATES; i++) {
-        free(Q[i]);
+    if (mode == MODE_FAST_TRAINING) {
+        simthread_stop(&fast);
+        epsilon = fast.epsilon;
+        episode = (int)fast.episode;
+        trainSteps = fast.trainSteps;
+    }
+    if (mode == MODE_REPLAY) playback_free(&playback);
+    sim.log = NULL;
+    actionlog_free(&recording);
+    actionlog_free(&lastLoss);
+    if (checkpointing) {
+        SubmitCheckpoint(&ck, Q, &params, epsilon, episode, trainSteps, seed, sim.rng.state, &botRng, true);
+        checkpoint_stop(&ck);
+    }
+    if (telemetryOn) telemetry_stop(&telemetry);
+    UnloadTextLayer(&textLayer);
+    UnloadBrickLayer(&brickLayer);
+    if (profiling) {
+        if (tracePath && !prof_export_trace(&prof, tracePath)) printf("Falha ao gravar o trace em %s\n", tracePath);
+        prof_free(&prof);
     }
-    free(Q);
+    free_q_table(Q);
     
     UnloadSounds();
-    CloseAudioDevice();
     CloseWindow();
+    if (levelPath) level_free(&level);
+    if (policyPath) policy_free(&policy);
     return 0;
 }
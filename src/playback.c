@@ -0,0 +1,58 @@
+#include "playback.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool playback_open(Playback *pb, const ActionLog *log, const Level *level) {
+    memset(pb, 0, sizeof(*pb));
+    if (!level) level = level_builtin();
+    if (!actionlog_level_matches(log, level)) return false;
+    long count = log->count / PLAYBACK_KEYFRAME_STEPS + 1;
+    size_t size = sim_pack_size(level);
+    pb->keyframes = (unsigned char *)malloc((size_t)count * size);
+    if (!pb->keyframes) return false;
+    pb->log = log;
+    pb->keyframeSize = size;
+    pb->keyframeCount = count;
+
+    // Mesmo início de actionlog_replay
+    SimState *sim = &pb->sim;
+    sim_init(sim, log->dt, 0);
+    sim->collision = log->collision;
+    sim->level = level;
+    sim->rng.state = log->rngState;
+    sim_reset(sim);
+    for (long i = 0; i < log->count; i++) {
+        if (i % PLAYBACK_KEYFRAME_STEPS == 0) sim_pack(sim, pb->keyframes + (i / PLAYBACK_KEYFRAME_STEPS) * size);
+        sim_step(sim, actionlog_get(log, i));
+    }
+    if (log->count % PLAYBACK_KEYFRAME_STEPS == 0) sim_pack(sim, pb->keyframes + (count - 1) * size);
+
+    sim_unpack(sim, pb->keyframes);
+    pb->step = 0;
+    return true;
+}
+
+void playback_seek(Playback *pb, long step) {
+    if (step < 0) step = 0;
+    if (step > pb->log->count) step = pb->log->count;
+    // Para a frente e dentro do mesmo intervalo basta continuar de onde está
+    long key = step / PLAYBACK_KEYFRAME_STEPS;
+    if (step < pb->step || key > pb->step / PLAYBACK_KEYFRAME_STEPS) {
+        sim_unpack(&pb->sim, pb->keyframes + key * pb->keyframeSize);
+        pb->step = key * PLAYBACK_KEYFRAME_STEPS;
+    }
+    playback_advance(pb, step - pb->step);
+}
+
+unsigned playback_advance(Playback *pb, long steps) {
+    unsigned events = 0;
+    long end = pb->step + steps;
+    if (end > pb->log->count) end = pb->log->count;
+    for (; pb->step < end; pb->step++) events |= sim_step(&pb->sim, actionlog_get(pb->log, pb->step));
+    return events;
+}
+
+void playback_free(Playback *pb) {
+    free(pb->keyframes);
+    memset(pb, 0, sizeof(*pb));
+}
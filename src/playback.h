@@ -0,0 +1,61 @@
+#ifndef PLAYBACK_H
+#define PLAYBACK_H
+
+#include "actionlog.h"
+#include "sim.h"
+#include <stdbool.h>
+
+/*
+ * Reprodução navegável de um episódio gravado (ActionLog). Ao abrir, o
+ * episódio é simulado uma vez do começo ao fim guardando o estado a cada
+ * PLAYBACK_KEYFRAME_STEPS passos, empacotado com sim_pack (só as palavras de
+ * tijolos do nível); ir a qualquer passo custa desempacotar o quadro-chave
+ * anterior e dar no máximo PLAYBACK_KEYFRAME_STEPS - 1 passos.
+ * A gravação continua só com gerador e ações: os quadros-chave existem apenas
+ * enquanto o episódio está aberto.
+ */
+
+// Passos entre quadros-chave (10 s de jogo no passo padrão)
+#define PLAYBACK_KEYFRAME_STEPS 600
+
+typedef struct {
+    const ActionLog *log;
+    SimState sim;           // estado depois de `step` passos
+    long step;              // passos aplicados, em [0, log->count]
+    unsigned char *keyframes;   // quadro k em k * keyframeSize: estado depois de k * PLAYBACK_KEYFRAME_STEPS passos
+    size_t keyframeSize;        // sim_pack_size do nível
+    long keyframeCount;
+} Playback;
+
+/**
+ * Abre um episódio: simula-o por inteiro, montando os quadros-chave, e
+ * volta ao passo 0.
+ * @param pb Reprodução (liberar com playback_free).
+ * @param log Registro; precisa viver enquanto a reprodução estiver aberta.
+ * @param level Nível em que o episódio foi gravado (NULL = embutido).
+ * @return false se faltou memória ou se o registro é de outro nível.
+ */
+bool playback_open(Playback *pb, const ActionLog *log, const Level *level);
+
+/**
+ * Vai direto a um passo do episódio.
+ * @param pb Reprodução.
+ * @param step Passo de destino (limitado a [0, log->count]).
+ */
+void playback_seek(Playback *pb, long step);
+
+/**
+ * Avança a partir do passo atual, parando no fim do episódio.
+ * @param pb Reprodução.
+ * @param steps Passos a dar.
+ * @return Bitmask de SIM_EVENT_* ocorridos nesses passos.
+ */
+unsigned playback_advance(Playback *pb, long steps);
+
+/**
+ * Libera os quadros-chave.
+ * @param pb Reprodução.
+ */
+void playback_free(Playback *pb);
+
+#endif // PLAYBACK_H
@@ -0,0 +1,118 @@
+#include "policy.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Garante em tempo de compilação que o cabeçalho tem 56 bytes
+typedef char PolicyHeaderSizeCheck[(sizeof(PolicyFileHeader) == 56) ? 1 : -1];
+
+// As ações precisam caber em 2 bits
+typedef char PolicyActionBitsCheck[(N_ACTIONS <= 4) ? 1 : -1];
+
+// Reserva ações e, se pedido, margens num só bloco
+static bool AllocPolicy(Policy *policy, const StateSpec *spec, bool margins, uint8_t **actions, uint8_t **marginBytes) {
+    size_t size = POLICY_ACTION_BYTES(spec->nStates) + (margins ? (size_t)spec->nStates : 0);
+    uint8_t *storage = (uint8_t *)calloc(1, size);
+    if (!storage) return false;
+    policy->spec = spec;
+    policy->storage = storage;
+    *actions = storage;
+    *marginBytes = margins ? storage + POLICY_ACTION_BYTES(spec->nStates) : NULL;
+    policy->actions = *actions;
+    policy->margins = *marginBytes;
+    return true;
+}
+
+// Q(melhor) - Q(segunda melhor) de um estado
+static float Margin(const QTable *Q, int state, int best) {
+    float second = -INFINITY;
+    for (int a = 0; a < N_ACTIONS; a++) {
+        float q = q_value(Q, state, a);
+        if (a != best && q > second) second = q;
+    }
+    return q_value(Q, state, best) - second;
+}
+
+bool policy_compile(Policy *policy, const QTable *Q, bool margins) {
+    memset(policy, 0, sizeof(*policy));
+    uint8_t *actions, *marginBytes;
+    if (!AllocPolicy(policy, Q->spec, margins, &actions, &marginBytes)) return false;
+
+    float maxMargin = 0.0f;
+    for (int s = 0; s < Q->nStates; s++) {
+        int best = greedy_action(Q, s);
+        actions[s >> 2] |= (uint8_t)(best << ((s & 3) * 2));
+        if (margins) {
+            float m = Margin(Q, s, best);
+            if (m > maxMargin) maxMargin = m;
+        }
+    }
+    if (margins && maxMargin > 0.0f) {
+        // Escala linear: a maior margem da tabela vira 255
+        policy->marginScale = maxMargin / 255.0f;
+        for (int s = 0; s < Q->nStates; s++) {
+            float m = Margin(Q, s, policy_action(policy, s)) / policy->marginScale + 0.5f;
+            marginBytes[s] = (uint8_t)(m > 255.0f ? 255.0f : m);
+        }
+    }
+    return true;
+}
+
+bool policy_save(const Policy *policy, const char *filename) {
+    PolicyFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, POLICY_MAGIC, sizeof(header.magic));
+    header.endianTag = POLICY_ENDIAN_TAG;
+    const StateSpec *spec = policy->spec;
+    header.nStates = (uint32_t)spec->nStates;
+    header.nActions = N_ACTIONS;
+    memcpy(header.bins, spec->bins, sizeof(header.bins));
+    header.specId = spec->id;
+    header.flags = policy->margins ? POLICY_HAS_MARGINS : 0;
+    header.marginScale = policy->marginScale;
+
+    const size_t actionBytes = POLICY_ACTION_BYTES(spec->nStates);
+    const size_t states = (size_t)spec->nStates;
+    FILE *file = fopen(filename, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+           && fwrite(policy->actions, 1, actionBytes, file) == actionBytes;
+    if (ok && policy->margins) ok = fwrite(policy->margins, 1, states, file) == states;
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+bool policy_load(Policy *policy, const char *filename) {
+    memset(policy, 0, sizeof(*policy));
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+
+    // Discretização conhecida e com as mesmas dimensões; ações as da compilação
+    PolicyFileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+           && memcmp(header.magic, POLICY_MAGIC, sizeof(header.magic)) == 0
+           && header.endianTag == POLICY_ENDIAN_TAG;
+    const StateSpec *spec = ok ? state_spec_by_id(header.specId) : NULL;
+    ok = spec && header.nStates == (uint32_t)spec->nStates && header.nActions == N_ACTIONS
+         && memcmp(header.bins, spec->bins, sizeof(header.bins)) == 0;
+    bool margins = ok && (header.flags & POLICY_HAS_MARGINS);
+    uint8_t *actions, *marginBytes;
+    ok = ok && AllocPolicy(policy, spec, margins, &actions, &marginBytes)
+            && fread(actions, 1, POLICY_ACTION_BYTES(spec->nStates), file) == POLICY_ACTION_BYTES(spec->nStates);
+    if (ok && margins) ok = fread(marginBytes, 1, (size_t)spec->nStates, file) == (size_t)spec->nStates;
+    fclose(file);
+    // O valor 3 não é ação
+    for (int s = 0; ok && s < spec->nStates; s++) ok = policy_action(policy, s) < N_ACTIONS;
+    if (!ok) {
+        policy_free(policy);
+        return false;
+    }
+    policy->marginScale = header.marginScale;
+    return true;
+}
+
+void policy_free(Policy *policy) {
+    free(policy->storage);
+    memset(policy, 0, sizeof(*policy));
+}
@@ -0,0 +1,114 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "bot.h"
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Política gulosa compilada de uma Q-table: só a ação argmax de cada estado,
+ * em 2 bits (4 estados por byte; nStates / 4 bytes, alguns KB que cabem na
+ * L1). Serve para jogar sem a Q-table: nada de floats nem de atualização, e
+ * várias instâncias podem compartilhar a mesma tabela somente leitura.
+ *
+ * Opcionalmente guarda a margem de confiança de cada estado, Q(melhor) -
+ * Q(segunda melhor), quantizada em 8 bits (0 = empate ou estado nunca
+ * visitado).
+ *
+ * A política guarda a discretização da Q-table de origem, gravada no arquivo.
+ *
+ * Arquivo: [PolicyFileHeader][nStates / 4 bytes de ações][nStates bytes de margens, se houver]
+ */
+
+#define POLICY_MAGIC        "ARKPOL1"   // 7 caracteres + '\0'
+#define POLICY_ENDIAN_TAG   0x01020304u
+#define POLICY_HAS_MARGINS  1u          // flags: margens gravadas
+
+// Bytes de ações empacotadas de uma política com nStates estados
+#define POLICY_ACTION_BYTES(nStates) (((size_t)(nStates) + 3) / 4)
+
+typedef struct {
+    const StateSpec *spec;      // discretização do estado
+    const uint8_t *actions;     // POLICY_ACTION_BYTES(spec->nStates): estado s nos bits 2*(s%4) do byte s/4
+    const uint8_t *margins;     // spec->nStates bytes, ou NULL sem margens
+    float marginScale;          // margem = margins[s] * marginScale
+    void *storage;              // bloco com ações e margens
+} Policy;
+
+// Cabeçalho do arquivo (56 bytes, campos em endianness nativa)
+typedef struct {
+    char magic[8];              // POLICY_MAGIC
+    uint32_t endianTag;         // POLICY_ENDIAN_TAG como escrito por quem salvou
+    uint32_t nStates;           // StateSpec.nStates
+    uint32_t nActions;          // N_ACTIONS
+    uint32_t bins[5];           // StateSpec.bins da discretização
+    uint32_t specId;            // StateSpec.id da discretização
+    uint32_t flags;             // POLICY_HAS_MARGINS
+    float marginScale;
+    uint32_t reserved;
+} PolicyFileHeader;
+
+/**
+ * Compila a política gulosa de uma Q-table (mesmo desempate de greedy_action).
+ * @param policy Saída (liberar com policy_free).
+ * @param Q Tabela Q (densa ou esparsa).
+ * @param margins Se true, guarda também a margem de cada estado.
+ * @return false se faltou memória.
+ */
+bool policy_compile(Policy *policy, const QTable *Q, bool margins);
+
+/**
+ * Salva a política em arquivo binário.
+ * @param policy Política.
+ * @param filename Caminho do arquivo.
+ * @return true se salvou.
+ */
+bool policy_save(const Policy *policy, const char *filename);
+
+/**
+ * Carrega uma política salva com policy_save, com a discretização gravada
+ * no arquivo. Discretizações desconhecidas e outra endianness são recusadas.
+ * @param policy Saída (liberar com policy_free).
+ * @param filename Caminho do arquivo.
+ * @return true se carregou.
+ */
+bool policy_load(Policy *policy, const char *filename);
+
+/**
+ * Libera a memória da política.
+ * @param policy Política.
+ */
+void policy_free(Policy *policy);
+
+/**
+ * Ação da política em um estado.
+ * @param policy Política.
+ * @param state Índice do estado.
+ * @return ACTION_LEFT, ACTION_STAY ou ACTION_RIGHT.
+ */
+static inline int policy_action(const Policy *policy, int state) {
+    return (policy->actions[state >> 2] >> ((state & 3) * 2)) & 3;
+}
+
+/**
+ * Margem de confiança de um estado.
+ * @param policy Política.
+ * @param state Índice do estado.
+ * @return Q(melhor) - Q(segunda melhor), aproximada, ou -1 sem margens.
+ */
+static inline float policy_margin(const Policy *policy, int state) {
+    return policy->margins ? policy->margins[state] * policy->marginScale : -1.0f;
+}
+
+/**
+ * Um passo do jogo com a ação da política (sem aprendizado).
+ * @param policy Política.
+ * @param sim Jogo.
+ * @return Bitmask de SIM_EVENT_* do passo.
+ */
+static inline unsigned policy_step(const Policy *policy, SimState *sim) {
+    return sim_step(sim, policy_action(policy, policy->spec->encode(sim->paddle, sim->ball)));
+}
+
+#endif // POLICY_H
@@ -0,0 +1,89 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef char ProfEventRingCheck[(PROF_MAX_EVENTS & (PROF_MAX_EVENTS - 1)) == 0 ? 1 : -1];
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Segundos por tick, medidos desde prof_init
+static double SecondsPerTick(const Profiler *p) {
+#ifdef PROF_HAVE_TSC
+    uint64_t ticks = prof_ticks() - p->originTicks;
+    uint64_t ns = NowNs() - p->originNs;
+    return ticks > 0 ? ns * 1e-9 / ticks : 0.0;
+#else
+    (void)p;
+    return 1e-9;
+#endif
+}
+
+bool prof_init(Profiler *p, const char *const *names, int zones) {
+    memset(p, 0, sizeof(*p));
+    p->events = (ProfEvent *)malloc(PROF_MAX_EVENTS * sizeof(ProfEvent));
+    if (!p->events) return false;
+    p->names = names;
+    p->zones = zones < PROF_MAX_ZONES ? zones : PROF_MAX_ZONES;
+    p->originNs = NowNs();
+    p->originTicks = prof_ticks();
+    return true;
+}
+
+void prof_free(Profiler *p) {
+    free(p->events);
+    p->events = NULL;
+}
+
+void prof_frame_end(Profiler *p) {
+    memcpy(p->history[p->frames % PROF_FRAMES], p->current, sizeof(p->current));
+    memset(p->current, 0, sizeof(p->current));
+    p->frames++;
+}
+
+static int CompareTicks(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void prof_stats(const Profiler *p, int zone, ProfStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    int n = p->frames < PROF_FRAMES ? (int)p->frames : PROF_FRAMES;
+    if (n == 0) return;
+
+    uint64_t sorted[PROF_FRAMES];
+    uint64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sorted[i] = p->history[i][zone];
+        sum += sorted[i];
+    }
+    qsort(sorted, n, sizeof(uint64_t), CompareTicks);
+    double ms = SecondsPerTick(p) * 1e3;
+    stats->min = sorted[0] * ms;
+    stats->avg = (double)sum / n * ms;
+    stats->p99 = sorted[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] * ms;
+}
+
+bool prof_export_trace(const Profiler *p, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    double us = SecondsPerTick(p) * 1e6;
+    long first = p->eventCount > PROF_MAX_EVENTS ? p->eventCount - PROF_MAX_EVENTS : 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (long i = first; i < p->eventCount; i++) {
+        const ProfEvent *e = &p->events[i & (PROF_MAX_EVENTS - 1)];
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                i > first ? ",\n" : "", p->names[e->zone],
+                (double)(e->begin - p->originTicks) * us, (double)(e->end - e->begin) * us);
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
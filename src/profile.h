@@ -0,0 +1,130 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PROF_HAVE_TSC 1
+#else
+#include <time.h>
+#endif
+
+/*
+ * Zonas de tempo do loop principal. Cada zona é aberta com prof_begin e
+ * fechada com prof_end; o tempo soma no quadro atual (uma zona pode abrir
+ * várias vezes por quadro) e cada abertura vira um evento num anel para o
+ * trace. prof_frame_end fecha o quadro e guarda os totais num anel de
+ * PROF_FRAMES quadros, de onde saem mínimo, média e p99 por zona.
+ *
+ * O relógio é o TSC (rdtsc, supondo TSC invariante, como nas CPUs atuais) ou
+ * CLOCK_MONOTONIC nas outras arquiteturas. A escala ticks -> segundos é
+ * calibrada contra CLOCK_MONOTONIC desde prof_init, sem espera na criação.
+ * O trace é gravado no formato JSON de eventos do Chrome (chrome://tracing,
+ * Perfetto).
+ */
+
+#define PROF_MAX_ZONES 16
+#define PROF_FRAMES 256             // quadros nas estatísticas (janela móvel)
+#define PROF_MAX_EVENTS 65536       // eventos guardados para o trace (anel)
+
+typedef struct {
+    uint64_t begin;                 // ticks
+    uint64_t end;
+    int zone;
+} ProfEvent;
+
+// Estatísticas de uma zona na janela móvel (milissegundos por quadro)
+typedef struct {
+    double min;
+    double avg;
+    double p99;
+} ProfStats;
+
+typedef struct {
+    const char *const *names;       // nome de cada zona
+    int zones;
+    uint64_t originTicks;           // calibração: ticks e ns em prof_init
+    uint64_t originNs;
+    uint64_t current[PROF_MAX_ZONES];               // ticks no quadro atual
+    uint64_t history[PROF_FRAMES][PROF_MAX_ZONES];  // ticks por quadro (anel)
+    long frames;                    // quadros fechados
+    ProfEvent *events;              // anel de eventos
+    long eventCount;                // eventos registrados (o anel guarda os últimos)
+} Profiler;
+
+/**
+ * Leitura do relógio em ticks.
+ */
+static inline uint64_t prof_ticks(void) {
+#ifdef PROF_HAVE_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * Prepara o profiler.
+ * @param p Profiler.
+ * @param names Nomes das zonas (o vetor deve viver enquanto o profiler existir).
+ * @param zones Número de zonas (até PROF_MAX_ZONES).
+ * @return true se o anel de eventos foi alocado.
+ */
+bool prof_init(Profiler *p, const char *const *names, int zones);
+
+/**
+ * Libera o profiler.
+ * @param p Profiler.
+ */
+void prof_free(Profiler *p);
+
+/**
+ * Abre uma zona.
+ * @return Instante de início, para prof_end.
+ */
+static inline uint64_t prof_begin(void) {
+    return prof_ticks();
+}
+
+/**
+ * Fecha uma zona aberta com prof_begin.
+ * @param p Profiler.
+ * @param zone Zona.
+ * @param begin Valor devolvido por prof_begin.
+ */
+static inline void prof_end(Profiler *p, int zone, uint64_t begin) {
+    uint64_t end = prof_ticks();
+    p->current[zone] += end - begin;
+    ProfEvent *e = &p->events[p->eventCount++ & (PROF_MAX_EVENTS - 1)];
+    e->begin = begin;
+    e->end = end;
+    e->zone = zone;
+}
+
+/**
+ * Fecha o quadro atual e abre o próximo.
+ * @param p Profiler.
+ */
+void prof_frame_end(Profiler *p);
+
+/**
+ * Mínimo, média e p99 de uma zona nos últimos PROF_FRAMES quadros.
+ * @param p Profiler.
+ * @param zone Zona.
+ * @param stats Saída em milissegundos.
+ */
+void prof_stats(const Profiler *p, int zone, ProfStats *stats);
+
+/**
+ * Grava os eventos guardados em JSON de trace do Chrome.
+ * @param p Profiler.
+ * @param path Caminho.
+ * @return true se gravou.
+ */
+bool prof_export_trace(const Profiler *p, const char *path);
+
+#endif // PROFILE_H
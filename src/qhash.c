@@ -0,0 +1,76 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "qhash.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool qhash_init(QHash *h, long states, int rowStride, const float *empty) {
+    memset(h, 0, sizeof(*h));
+    if (states <= 0 || rowStride <= 0) return false;
+    long cap = 16;
+    while ((double)cap * QHASH_MAX_LOAD < (double)states) cap <<= 1;
+
+    // Uma linha a mais no fim: a linha vazia dos estados ausentes
+    size_t rowBytes = (size_t)(cap + 1) * rowStride * sizeof(float);
+    if (posix_memalign((void **)&h->rows, 64, rowBytes) != 0) return false;
+    h->keys = (int32_t *)malloc((size_t)cap * sizeof(int32_t));
+    if (!h->keys) {
+        free(h->rows);
+        h->rows = NULL;
+        return false;
+    }
+    memset(h->keys, 0xff, (size_t)cap * sizeof(int32_t));
+    for (long i = 0; i <= cap; i++) memcpy(h->rows + (size_t)i * rowStride, empty, rowStride * sizeof(float));
+
+    h->capacity = cap;
+    h->limit = (long)((double)cap * QHASH_MAX_LOAD);
+    h->rowStride = rowStride;
+    h->empty = h->rows + (size_t)cap * rowStride;
+    return true;
+}
+
+void qhash_free(QHash *h) {
+    free(h->keys);
+    free(h->rows);
+    memset(h, 0, sizeof(*h));
+}
+
+float *qhash_insert(QHash *h, int32_t state) {
+    for (long i = qhash_home(h, state);; i = (i + 1) & (h->capacity - 1)) {
+        int32_t key = __atomic_load_n(&h->keys[i], __ATOMIC_ACQUIRE);
+        if (key == state) return h->rows + (size_t)i * h->rowStride;
+        if (key >= 0) continue;
+
+        // Reserva uma vaga da cota antes de tomar a posição
+        if (__atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED) >= h->limit) {
+            __atomic_fetch_sub(&h->count, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&h->overflow, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        int32_t expected = -1;
+        if (__atomic_compare_exchange_n(&h->keys[i], &expected, state, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return h->rows + (size_t)i * h->rowStride;
+        }
+        // Outra thread tomou a posição: devolve a vaga e confere quem entrou
+        __atomic_fetch_sub(&h->count, 1, __ATOMIC_RELAXED);
+        if (expected == state) return h->rows + (size_t)i * h->rowStride;
+    }
+}
+
+void qhash_stats(const QHash *h, QHashStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    long probes = 0;
+    for (long i = 0; i < h->capacity; i++) {
+        int32_t key = __atomic_load_n(&h->keys[i], __ATOMIC_RELAXED);
+        if (key < 0) continue;
+        int probe = (int)(((i - qhash_home(h, key)) & (h->capacity - 1)) + 1);
+        probes += probe;
+        if (probe > stats->maxProbe) stats->maxProbe = probe;
+        stats->states++;
+    }
+    stats->capacity = h->capacity;
+    stats->overflow = __atomic_load_n(&h->overflow, __ATOMIC_RELAXED);
+    stats->load = h->capacity > 0 ? (double)stats->states / h->capacity : 0.0;
+    stats->meanProbe = stats->states > 0 ? (double)probes / stats->states : 0.0;
+    stats->bytes = (size_t)h->capacity * sizeof(int32_t) + (size_t)(h->capacity + 1) * h->rowStride * sizeof(float);
+}
@@ -0,0 +1,97 @@
+#ifndef QHASH_H
+#define QHASH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Armazenamento esparso da Q-table: endereçamento aberto com sondagem linear,
+ * chave = índice do estado, valor = a linha de Q_STRIDE floats. Só os estados
+ * visitados ocupam posições, então a memória depende de quantos estados o
+ * agente realmente vê e não do produto dos bins. A capacidade é fixa (escolhida
+ * na criação) para que várias threads possam inserir sem locks: uma posição é
+ * reservada com CAS na chave e as linhas já nascem zeradas. Acima de
+ * QHASH_MAX_LOAD a tabela recusa estados novos (eles leem como zero e as
+ * atualizações são descartadas e contadas em overflow).
+ *
+ * O tamanho da linha é passado em rowStride para não depender de bot.h.
+ */
+
+#define QHASH_MAX_LOAD 0.85f    // ocupação máxima antes de recusar estados novos
+
+typedef struct {
+    long capacity;          // posições (potência de 2)
+    long limit;             // estados aceitos no máximo (capacity * QHASH_MAX_LOAD)
+    long count;             // estados inseridos
+    long overflow;          // inserções recusadas por falta de espaço
+    int rowStride;          // floats por linha
+    int32_t *keys;          // estado de cada posição (-1 = vazia)
+    float *rows;            // capacity * rowStride floats, alinhado a 64
+    const float *empty;     // linha devolvida para estados ausentes (após as demais)
+} QHash;
+
+// Ocupação e custo de busca, para comparar memória com resolução
+typedef struct {
+    long states;            // estados inseridos
+    long capacity;          // posições
+    long overflow;          // inserções recusadas
+    double load;            // states / capacity
+    double meanProbe;       // posições examinadas por busca bem-sucedida (média)
+    int maxProbe;           // pior busca bem-sucedida
+    size_t bytes;           // memória da tabela
+} QHashStats;
+
+/**
+ * Aloca a tabela.
+ * @param h Tabela.
+ * @param states Estados que devem caber (a capacidade é arredondada para
+ *               potência de 2 acima de states / QHASH_MAX_LOAD).
+ * @param rowStride Floats por linha.
+ * @param empty Linha inicial (rowStride floats), copiada para cada posição e
+ *              para a linha devolvida a estados ausentes.
+ * @return true se a alocação funcionou.
+ */
+bool qhash_init(QHash *h, long states, int rowStride, const float *empty);
+
+/**
+ * Libera a tabela.
+ * @param h Tabela.
+ */
+void qhash_free(QHash *h);
+
+// Posição inicial da chave (hash multiplicativo de Fibonacci, 64 bits)
+static inline long qhash_home(const QHash *h, int32_t state) {
+    return (long)(((uint64_t)(uint32_t)state * 0x9E3779B97F4A7C15ull) >> 32) & (h->capacity - 1);
+}
+
+/**
+ * Linha de um estado para leitura.
+ * @param h Tabela.
+ * @param state Estado.
+ * @return Linha do estado, ou h->empty se ele nunca foi inserido.
+ */
+static inline const float *qhash_row(const QHash *h, int32_t state) {
+    for (long i = qhash_home(h, state);; i = (i + 1) & (h->capacity - 1)) {
+        int32_t key = __atomic_load_n(&h->keys[i], __ATOMIC_ACQUIRE);
+        if (key == state) return h->rows + (size_t)i * h->rowStride;
+        if (key < 0) return h->empty;
+    }
+}
+
+/**
+ * Linha de um estado para escrita, inserindo-o se preciso (sem locks).
+ * @param h Tabela.
+ * @param state Estado.
+ * @return Linha do estado, ou NULL se a tabela está no limite de ocupação.
+ */
+float *qhash_insert(QHash *h, int32_t state);
+
+/**
+ * Mede ocupação, comprimento de sondagem e memória (percorre a tabela).
+ * @param h Tabela.
+ * @param stats Saída.
+ */
+void qhash_stats(const QHash *h, QHashStats *stats);
+
+#endif // QHASH_H
@@ -1,74 +1,234 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "qtable_io.h"
 #include "bot.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-bool save_qtable(float **Q, const char *filename) {
-    FILE *file = fopen(filename, "wb");
-    if (!file) return false;
-    
-    // Escreve header com dimensões
-    int states = N_STATES;
-    int actions = N_ACTIONS;
-    fwrite(&states, sizeof(int), 1, file);
-    fwrite(&actions, sizeof(int), 1, file);
-    
-    // Escreve os dados da Q-table
-    for (int i = 0; i < N_STATES; i++) {
-        fwrite(Q[i], sizeof(float), N_ACTIONS, file);
+// Garante em tempo de compilação que o cabeçalho tem 144 bytes
+typedef char QTableHeaderSizeCheck[(sizeof(QTableFileHeader) == 144) ? 1 : -1];
+
+// Os bins do cabeçalho são os do descritor, copiados inteiros
+typedef char QTableBinsCheck[(sizeof(((QTableFileHeader *)0)->bins) == sizeof(((StateSpec *)0)->bins)) ? 1 : -1];
+
+// CRC-32 (IEEE 802.3, polinômio refletido 0xEDB88320)
+static uint32_t Crc32(const void *data, size_t size, uint32_t crc) {
+    uint32_t table[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t HeaderCrc(const QTableFileHeader *h) {
+    QTableFileHeader copy = *h;
+    copy.headerCrc = 0;
+    return Crc32(&copy, sizeof(copy), 0);
+}
+
+static size_t DataSize(const QTable *Q) {
+    return (size_t)Q->nStates * Q_STRIDE * sizeof(float);
+}
+
+// Confere se o cabeçalho é íntegro e de uma discretização conhecida; devolve
+// a discretização do arquivo (NULL se inválido)
+static const StateSpec *ValidateHeader(const QTableFileHeader *h, uint64_t fileSize) {
+    if (memcmp(h->magic, QTABLE_MAGIC, sizeof(QTABLE_MAGIC)) != 0) return NULL;
+    if (h->endianTag != QTABLE_ENDIAN_TAG) return NULL;   // gravado em outra endianness
+    if (h->version != QTABLE_VERSION || h->headerSize != sizeof(QTableFileHeader)) return NULL;
+    if (h->headerCrc != HeaderCrc(h)) return NULL;
+
+    // Discretização e layout das linhas precisam bater com um preset desta compilação
+    const StateSpec *spec = state_spec_by_id(h->specId);
+    if (!spec) return NULL;
+    if (h->nStates != (uint32_t)spec->nStates || h->nActions != N_ACTIONS || h->stride != Q_STRIDE) return NULL;
+    if (memcmp(h->bins, spec->bins, sizeof(h->bins)) != 0) return NULL;
+
+    if (h->dataSize != (uint64_t)spec->nStates * Q_STRIDE * sizeof(float)) return NULL;
+    if (h->dataOffset % QTABLE_DATA_ALIGN != 0) return NULL;
+    // Sem somar offset e tamanho: um dataOffset perto de 2^64 daria a volta
+    if (h->dataOffset < sizeof(QTableFileHeader) || h->dataOffset > fileSize) return NULL;
+    if (h->dataSize > fileSize - h->dataOffset) return NULL;
+    return spec;
+}
+
+// As colunas de padding de cada linha precisam ser -INFINITY: RowArgmax e
+// RowMax varrem Q_STRIDE colunas e um valor qualquer ali viraria a ação 3.
+// Barato perto do CRC, então é conferido mesmo sem verify
+static bool PaddingValid(const float *data, int nStates) {
+    for (int s = 0; s < nStates; s++) {
+        const float *row = data + (size_t)s * Q_STRIDE;
+        for (int a = N_ACTIONS; a < Q_STRIDE; a++) {
+            if (!isinf(row[a]) || row[a] > 0.0f) return false;
+        }
     }
-    
-    fclose(file);
     return true;
 }
 
-bool load_qtable(float **Q, const char *filename) {
-    FILE *file = fopen(filename, "rb");
-    if (!file) return false;
-    
-    // Lê header e verifica dimensões
-    int states, actions;
-    if (fread(&states, sizeof(int), 1, file) != 1) {
-        fclose(file);
+bool save_qtable(const QTable *Q, const char *filename) {
+    return save_qtable_meta(Q, NULL, filename);
+}
+
+bool save_qtable_meta(const QTable *Q, const QTableMeta *meta, const char *filename) {
+    QTableFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, QTABLE_MAGIC, sizeof(QTABLE_MAGIC));
+    h.endianTag = QTABLE_ENDIAN_TAG;
+    h.version = QTABLE_VERSION;
+    h.headerSize = sizeof(QTableFileHeader);
+    h.nStates = (uint32_t)Q->nStates;
+    h.nActions = N_ACTIONS;
+    h.stride = Q_STRIDE;
+    memcpy(h.bins, Q->spec->bins, sizeof(h.bins));
+    h.specId = Q->spec->id;
+    h.dataOffset = QTABLE_DATA_ALIGN;
+    h.dataSize = DataSize(Q);
+
+    // Tabela esparsa: grava no formato denso de sempre, materializado aqui
+    float *dense = NULL;
+    const float *data = Q->data;
+    if (Q->hash) {
+        dense = (float *)malloc(DataSize(Q));
+        if (!dense) return false;
+        q_export_dense(Q, dense);
+        data = dense;
+    }
+    h.dataCrc = Crc32(data, DataSize(Q), 0);
+    if (meta) h.meta = *meta;
+    h.headerCrc = HeaderCrc(&h);
+
+    // Escreve em um temporário e renomeia: um leitor nunca vê o arquivo pela metade
+    size_t len = strlen(filename);
+    char *tmpName = (char *)malloc(len + 5);
+    if (!tmpName) {
+        free(dense);
         return false;
     }
-    if (fread(&actions, sizeof(int), 1, file) != 1) {
-        fclose(file);
+    memcpy(tmpName, filename, len);
+    memcpy(tmpName + len, ".tmp", 5);
+
+    FILE *file = fopen(tmpName, "wb");
+    if (!file) {
+        free(tmpName);
+        free(dense);
         return false;
     }
-    
-    if (states != N_STATES || actions != N_ACTIONS) {
-        fclose(file);
-        return false; // Dimensões incompatíveis
+
+    static const char zeros[QTABLE_DATA_ALIGN];
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1
+           && fwrite(zeros, 1, QTABLE_DATA_ALIGN - sizeof(h), file) == QTABLE_DATA_ALIGN - sizeof(h)
+           && fwrite(data, 1, DataSize(Q), file) == DataSize(Q);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(tmpName, filename) == 0;
+    if (!ok) remove(tmpName);
+    free(tmpName);
+    free(dense);
+    return ok;
+}
+
+// Formato antigo: dois ints (estados, ações) seguidos das linhas sem padding
+static bool LoadLegacy(QTable *Q, FILE *file) {
+    int states, actions;
+    rewind(file);
+    if (fread(&states, sizeof(int), 1, file) != 1) return false;
+    if (fread(&actions, sizeof(int), 1, file) != 1) return false;
+    if (states != Q->nStates || actions != N_ACTIONS) return false; // Dimensões incompatíveis
+
+    for (int i = 0; i < Q->nStates; i++) {
+        if (fread(q_row(Q, i), sizeof(float), N_ACTIONS, file) != N_ACTIONS) return false;
     }
-    
-    // Lê os dados da Q-table
-    for (int i = 0; i < N_STATES; i++) {
-        if (fread(Q[i], sizeof(float), N_ACTIONS, file) != N_ACTIONS) {
-            fclose(file);
-            return false;
-        }
+    return true;
+}
+
+bool load_qtable(QTable *Q, const char *filename) {
+    if (Q->hash) return false;  // carregue na densa e converta com init_q_table_hashed
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+
+    QTableFileHeader h;
+    bool ok;
+    if (fread(&h, sizeof(h), 1, file) == 1 && memcmp(h.magic, QTABLE_MAGIC, sizeof(QTABLE_MAGIC)) == 0) {
+        struct stat st;
+        ok = fstat(fileno(file), &st) == 0
+          && ValidateHeader(&h, (uint64_t)st.st_size) == Q->spec
+          && fseek(file, (long)h.dataOffset, SEEK_SET) == 0
+          && fread(Q->data, 1, h.dataSize, file) == h.dataSize
+          && Crc32(Q->data, h.dataSize, 0) == h.dataCrc
+          && PaddingValid(Q->data, Q->nStates);
+    } else {
+        ok = LoadLegacy(Q, file);
     }
-    
+
     fclose(file);
-    return true;
+    return ok;
+}
+
+QTable *map_qtable(const char *filename, QTableMeta *meta, bool verify) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(QTableFileHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    // Privado e gravável: a tabela pode continuar treinando sem tocar o arquivo
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const QTableFileHeader *h = (const QTableFileHeader *)base;
+    QTable *Q = NULL;
+    const StateSpec *spec = ValidateHeader(h, size);
+    if (spec) {
+        float *data = (float *)((char *)base + h->dataOffset);
+        if (PaddingValid(data, spec->nStates) && (!verify || Crc32(data, h->dataSize, 0) == h->dataCrc)) {
+            Q = (QTable *)malloc(sizeof(QTable));
+        }
+        if (Q) {
+            Q->data = data;
+            Q->nStates = spec->nStates;
+            Q->spec = spec;
+            Q->mapBase = base;
+            Q->mapSize = size;
+            Q->hash = NULL;
+            if (meta) *meta = h->meta;
+        }
+    }
+
+    if (!Q) munmap(base, size);
+    return Q;
 }
 
-bool save_qtable_text(float **Q, const char *filename) {
+bool save_qtable_text(const QTable *Q, const char *filename) {
     FILE *file = fopen(filename, "w");
     if (!file) return false;
     
-    fprintf(file, "Q-Table: %d states x %d actions\n", N_STATES, N_ACTIONS);
+    fprintf(file, "Q-Table: %d states x %d actions\n", Q->nStates, N_ACTIONS);
     fprintf(file, "State,Left,Stay,Right\n");
     
-    for (int i = 0; i < N_STATES; i++) {
+    for (int i = 0; i < Q->nStates; i++) {
         fprintf(file, "%d", i);
         for (int a = 0; a < N_ACTIONS; a++) {
-            fprintf(file, ",%.6f", Q[i][a]);
+            fprintf(file, ",%.6f", q_value(Q, i, a));
         }
         fprintf(file, "\n");
     }
     
     fclose(file);
     return true;
-}
\ No newline at end of file
+}
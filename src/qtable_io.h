@@ -4,22 +4,98 @@
 #include "bot.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Formato binário da Q-table (versão 2):
+ *
+ *   [cabeçalho QTableFileHeader][zeros até dataOffset][linhas]
+ *
+ * As linhas são gravadas exatamente como ficam na memória (Q_STRIDE floats
+ * por estado, com o preenchimento -INFINITY) e começam em um múltiplo do
+ * tamanho de página, de modo que o arquivo pode ser mapeado com mmap e usado
+ * diretamente como Q-table, sem cópia. O cabeçalho guarda a discretização
+ * usada no treino e CRCs do cabeçalho e dos dados; um arquivo de
+ * discretização desconhecida, de outra endianness ou corrompido é recusado.
+ */
+
+#define QTABLE_MAGIC        "ARKQTBL"   // 7 caracteres + '\0'
+#define QTABLE_VERSION      2
+#define QTABLE_ENDIAN_TAG   0x01020304u
+#define QTABLE_DATA_ALIGN   4096        // alinhamento do início das linhas
+
+// Metadados de treino gravados junto com a tabela
+typedef struct {
+    float alpha;            // taxa de aprendizado
+    float gamma;            // fator de desconto
+    float epsilon;          // exploração no momento do salvamento
+    uint32_t reserved;
+    int64_t episodes;       // episódios treinados
+    int64_t steps;          // passos treinados
+    uint64_t seed;          // semente do treino
+    uint64_t simRng;        // estado do gerador do jogo (para retomar)
+    uint64_t agentRng;      // estado do gerador do agente (para retomar)
+} QTableMeta;
+
+// Cabeçalho do arquivo (144 bytes, campos em endianness nativa)
+typedef struct {
+    char magic[8];          // QTABLE_MAGIC
+    uint32_t endianTag;     // QTABLE_ENDIAN_TAG como escrito por quem salvou
+    uint32_t version;       // QTABLE_VERSION
+    uint32_t headerSize;    // sizeof(QTableFileHeader)
+    uint32_t nStates;       // linhas
+    uint32_t nActions;      // ações válidas por linha
+    uint32_t stride;        // floats por linha (Q_STRIDE)
+    uint32_t bins[5];       // StateSpec.bins da discretização
+    uint32_t headerCrc;     // CRC-32 do cabeçalho com este campo zerado
+    uint64_t dataOffset;    // início das linhas no arquivo
+    uint64_t dataSize;      // bytes de linhas
+    uint32_t dataCrc;       // CRC-32 das linhas
+    uint32_t specId;        // StateSpec.id da discretização (0 = padrão)
+    QTableMeta meta;        // metadados de treino
+    uint8_t pad[8];
+} QTableFileHeader;
+
+/**
+ * Salva a Q-table em um arquivo binário (formato versão 2).
+ * A escrita vai para um arquivo temporário que só substitui o destino
+ * quando está completo.
+ * @param Q Ponteiro para a Q-table.
+ * @param filename Nome do arquivo para salvar.
+ * @return true se salvou com sucesso, false caso contrário.
+ */
+bool save_qtable(const QTable *Q, const char *filename);
 
 /**
- * Salva a Q-table em um arquivo binário.
+ * Igual a save_qtable, gravando também os metadados de treino.
  * @param Q Ponteiro para a Q-table.
+ * @param meta Metadados (pode ser NULL).
  * @param filename Nome do arquivo para salvar.
  * @return true se salvou com sucesso, false caso contrário.
  */
-bool save_qtable(float **Q, const char *filename);
+bool save_qtable_meta(const QTable *Q, const QTableMeta *meta, const char *filename);
 
 /**
- * Carrega a Q-table de um arquivo binário.
- * @param Q Ponteiro para a Q-table (deve estar já alocada).
+ * Carrega a Q-table de um arquivo binário, copiando as linhas.
+ * Aceita o formato versão 2 e o formato antigo (dois ints + floats).
+ * @param Q Ponteiro para a Q-table (densa, já alocada com a discretização do arquivo).
  * @param filename Nome do arquivo para carregar.
  * @return true se carregou com sucesso, false caso contrário.
  */
-bool load_qtable(float **Q, const char *filename);
+bool load_qtable(QTable *Q, const char *filename);
+
+/**
+ * Mapeia um arquivo versão 2 na memória e o usa como Q-table, sem cópia.
+ * O mapeamento é privado (copy-on-write): atualizações da tabela não
+ * alteram o arquivo. A tabela fica com a discretização gravada no arquivo.
+ * Libere com free_q_table.
+ * @param filename Nome do arquivo.
+ * @param meta Saída opcional com os metadados de treino.
+ * @param verify Se true, confere o CRC das linhas antes de aceitar (o padding
+ *        -INFINITY das linhas é conferido sempre).
+ * @return Q-table mapeada, ou NULL se o arquivo for inválido ou incompatível.
+ */
+QTable *map_qtable(const char *filename, QTableMeta *meta, bool verify);
 
 /**
  * Salva a Q-table em formato texto (para debug/análise).
@@ -27,6 +103,6 @@ bool load_qtable(float **Q, const char *filename);
  * @param filename Nome do arquivo para salvar.
  * @return true se salvou com sucesso, false caso contrário.
  */
-bool save_qtable_text(float **Q, const char *filename);
+bool save_qtable_text(const QTable *Q, const char *filename);
 
-#endif // QTABLE_IO_H
\ No newline at end of file
+#endif // QTABLE_IO_H
@@ -0,0 +1,105 @@
+#include "render.h"
+#include <string.h>
+
+// Desenha uma textura de render na tela inteira (o eixo y delas é invertido)
+static void DrawTarget(RenderTexture2D target) {
+    DrawTextureRec(target.texture, (Rectangle){ 0, 0, (float)target.texture.width, -(float)target.texture.height },
+                   (Vector2){ 0, 0 }, WHITE);
+}
+
+static void DrawBorders(void) {
+    DrawRectangle(0, 0, SCREEN_W, 4, WHITE); // Topo
+    DrawRectangle(0, SCREEN_H - 4, SCREEN_W, 4, WHITE); // Base
+    DrawRectangle(0, 0, 4, SCREEN_H, WHITE); // Esquerda
+    DrawRectangle(SCREEN_W - 4, 0, 4, SCREEN_H, WHITE); // Direita
+}
+
+/* ---------- Tijolos ---------- */
+
+void InitBrickLayer(BrickLayer *layer) {
+    memset(layer, 0, sizeof(*layer));
+    layer->target = LoadRenderTexture(SCREEN_W, SCREEN_H);
+}
+
+void UpdateBrickLayer(BrickLayer *layer, const Level *level, const uint64_t *alive) {
+    // Algum tijolo novo: redesenha tudo; só destruídos: apaga cada um
+    int words = level->rows * level->words;
+    bool added = !layer->valid || layer->level != level, removed = false;
+    for (int w = 0; w < words && !added; ++w) {
+        if (alive[w] & ~layer->drawn[w]) added = true;
+        if (layer->drawn[w] & ~alive[w]) removed = true;
+    }
+    if (!added && !removed) return;
+
+    BeginTextureMode(layer->target);
+    if (added) {
+        ClearBackground(BLACK);
+        DrawBorders();
+    }
+    for (int w = 0; w < words; ++w) {
+        uint64_t bits = added ? alive[w] : layer->drawn[w] & ~alive[w];
+        int r = w / level->words, base = (w % level->words) << 6;
+        while (bits) {
+            int c = base + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            DrawRectangleRec(level_brick_rect(level, r, c), added ? level_brick_color(level, r, c) : BLACK);
+        }
+    }
+    EndTextureMode();
+
+    memcpy(layer->drawn, alive, (size_t)words * sizeof(uint64_t));
+    layer->level = level;
+    layer->valid = true;
+}
+
+void DrawBrickLayer(const BrickLayer *layer) {
+    DrawTarget(layer->target);
+}
+
+void UnloadBrickLayer(BrickLayer *layer) {
+    UnloadRenderTexture(layer->target);
+    layer->valid = false;
+}
+
+/* ---------- Textos ---------- */
+
+void InitTextLayer(TextLayer *layer) {
+    memset(layer, 0, sizeof(*layer));
+    layer->target = LoadRenderTexture(SCREEN_W, SCREEN_H);
+    layer->dirty = true;
+}
+
+void SetTextLabel(TextLayer *layer, int index, const char *text, int x, int y, int size, Color color) {
+    UiLabel *l = &layer->labels[index];
+    if (l->x == x && l->y == y && l->size == size && memcmp(&l->color, &color, sizeof(Color)) == 0
+        && strncmp(l->text, text, UI_LABEL_MAX - 1) == 0) return;
+    strncpy(l->text, text, UI_LABEL_MAX - 1);
+    l->text[UI_LABEL_MAX - 1] = '\0';
+    l->x = x;
+    l->y = y;
+    l->size = size;
+    l->color = color;
+    layer->dirty = true;
+}
+
+void UpdateTextLayer(TextLayer *layer) {
+    if (!layer->dirty) return;
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    for (int i = 0; i < UI_MAX_LABELS; i++) {
+        const UiLabel *l = &layer->labels[i];
+        if (l->text[0] == '\0') continue;
+        int x = l->x == UI_CENTER ? SCREEN_W / 2 - MeasureText(l->text, l->size) / 2 : l->x;
+        DrawText(l->text, x, l->y, l->size, l->color);
+    }
+    EndTextureMode();
+    layer->dirty = false;
+}
+
+void DrawTextLayer(const TextLayer *layer) {
+    DrawTarget(layer->target);
+}
+
+void UnloadTextLayer(TextLayer *layer) {
+    UnloadRenderTexture(layer->target);
+}
@@ -0,0 +1,98 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "defs.h"
+#include "level.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Camadas de desenho em cache (só na janela). O campo de tijolos e as bordas
+ * ficam numa textura do tamanho da tela que substitui o ClearBackground: a
+ * cada quadro ela é desenhada com um único quad, e só os tijolos destruídos
+ * desde o quadro anterior são apagados nela. Tijolos que reaparecem (reinício
+ * do jogo) ou a troca de nível fazem a textura ser redesenhada inteira.
+ *
+ * Os textos da interface ficam em outra textura transparente, refeita apenas
+ * quando algum rótulo muda (e com ela o MeasureText dos centralizados).
+ */
+
+#define UI_MAX_LABELS 8
+#define UI_LABEL_MAX 96         // bytes por rótulo, com o '\0'
+#define UI_CENTER (-1)          // x de um rótulo centralizado na tela
+
+typedef struct {
+    RenderTexture2D target;     // fundo, bordas e tijolos
+    const Level *level;         // nível desenhado na textura
+    uint64_t drawn[LEVEL_FIELD_WORDS]; // tijolos presentes na textura (mesmo layout do BrickField)
+    bool valid;                 // textura já desenhada ao menos uma vez
+} BrickLayer;
+
+typedef struct {
+    char text[UI_LABEL_MAX];    // vazio = oculto
+    int x, y;                   // x = UI_CENTER centraliza
+    int size;
+    Color color;
+} UiLabel;
+
+typedef struct {
+    RenderTexture2D target;     // rótulos sobre fundo transparente
+    UiLabel labels[UI_MAX_LABELS];
+    bool dirty;                 // algum rótulo mudou desde o último desenho
+} TextLayer;
+
+/**
+ * Cria a textura dos tijolos (precisa da janela aberta).
+ * @param layer Camada.
+ */
+void InitBrickLayer(BrickLayer *layer);
+
+/**
+ * Leva a textura ao estado atual do campo. Chamar fora de BeginDrawing.
+ * @param layer Camada.
+ * @param level Nível (geometria e cores).
+ * @param alive Bitset de tijolos vivos (BrickField.alive ou SimSnapshot.bricks).
+ */
+void UpdateBrickLayer(BrickLayer *layer, const Level *level, const uint64_t *alive);
+
+/**
+ * Desenha fundo, bordas e tijolos (no lugar de ClearBackground).
+ * @param layer Camada.
+ */
+void DrawBrickLayer(const BrickLayer *layer);
+
+void UnloadBrickLayer(BrickLayer *layer);
+
+/**
+ * Cria a textura dos textos com todos os rótulos ocultos.
+ * @param layer Camada.
+ */
+void InitTextLayer(TextLayer *layer);
+
+/**
+ * Define um rótulo; a camada só é marcada para refazer se algo mudou.
+ * @param layer Camada.
+ * @param index Rótulo (0 .. UI_MAX_LABELS-1).
+ * @param text Texto ("" oculta o rótulo).
+ * @param x Posição x, ou UI_CENTER.
+ * @param y Posição y.
+ * @param size Tamanho da fonte.
+ * @param color Cor.
+ */
+void SetTextLabel(TextLayer *layer, int index, const char *text, int x, int y, int size, Color color);
+
+/**
+ * Redesenha a textura se algum rótulo mudou. Chamar fora de BeginDrawing.
+ * @param layer Camada.
+ */
+void UpdateTextLayer(TextLayer *layer);
+
+/**
+ * Desenha a textura dos textos.
+ * @param layer Camada.
+ */
+void DrawTextLayer(const TextLayer *layer);
+
+void UnloadTextLayer(TextLayer *layer);
+
+#endif // RENDER_H
@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "replaybuf.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Tentativas da aceitação estocástica antes de aceitar a posição sorteada
+#define REPLAY_MAX_TRIES 64
+
+// Floats com atomicidade relaxada (mesmo esquema de QLoad/QStore em bot.c)
+static inline float LoadF(const float *p) {
+    float v;
+    __atomic_load(p, &v, __ATOMIC_RELAXED);
+    return v;
+}
+
+static inline void StoreF(float *p, float v) {
+    __atomic_store(p, &v, __ATOMIC_RELAXED);
+}
+
+// Vetores de 4 bytes ou menos alinhados a uma linha de cache
+static size_t Align64(size_t bytes) {
+    return (bytes + 63) & ~(size_t)63;
+}
+
+bool replay_init(ReplayBuffer *rb, long capacity, float priorityAlpha, float priorityBeta) {
+    memset(rb, 0, sizeof(*rb));
+    if (capacity <= 0) return false;
+    long cap = 1;
+    while (cap < capacity) cap <<= 1;
+
+    size_t n = (size_t)cap;
+    size_t i32 = Align64(n * sizeof(int32_t));
+    size_t u8 = Align64(n);
+    size_t u64 = Align64(n * sizeof(uint64_t));
+    size_t total = u64 + 4 * i32 + 2 * u8;
+    void *block = NULL;
+    if (posix_memalign(&block, 64, total) != 0) return false;
+    memset(block, 0, total);
+
+    char *p = (char *)block;
+    rb->seq      = (uint64_t *)p; p += u64;
+    rb->state    = (int *)p;      p += i32;
+    rb->next     = (int *)p;      p += i32;
+    rb->reward   = (float *)p;    p += i32;
+    rb->priority = (float *)p;    p += i32;
+    rb->action   = (uint8_t *)p;  p += u8;
+    rb->done     = (uint8_t *)p;
+    rb->block = block;
+    rb->capacity = cap;
+    rb->maxPriority = 1.0f;
+    rb->priorityAlpha = priorityAlpha > 0.0f ? priorityAlpha : 0.0f;
+    rb->priorityBeta = priorityBeta > 0.0f ? priorityBeta : 0.0f;
+    return true;
+}
+
+void replay_free(ReplayBuffer *rb) {
+    free(rb->block);
+    memset(rb, 0, sizeof(*rb));
+}
+
+void replay_push(ReplayBuffer *rb, int state, int action, float reward, int next, bool done) {
+    long ticket = __atomic_fetch_add(&rb->cursor, 1, __ATOMIC_RELAXED);
+    long i = ticket & (rb->capacity - 1);
+
+    // Marca a posição como em escrita; leitores que a pegarem agora descartam
+    __atomic_store_n(&rb->seq[i], 2 * (uint64_t)ticket + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&rb->state[i], state, __ATOMIC_RELAXED);
+    __atomic_store_n(&rb->next[i], next, __ATOMIC_RELAXED);
+    StoreF(&rb->reward[i], reward);
+    __atomic_store_n(&rb->action[i], (uint8_t)action, __ATOMIC_RELAXED);
+    __atomic_store_n(&rb->done[i], (uint8_t)done, __ATOMIC_RELAXED);
+    StoreF(&rb->priority[i], LoadF(&rb->maxPriority));
+    __atomic_store_n(&rb->seq[i], 2 * (uint64_t)ticket + 2, __ATOMIC_RELEASE);
+}
+
+long replay_size(const ReplayBuffer *rb) {
+    long n = __atomic_load_n(&rb->cursor, __ATOMIC_RELAXED);
+    return n < rb->capacity ? n : rb->capacity;
+}
+
+// Copia a posição i para o minilote; false se estava vazia ou em escrita
+static bool ReadSlot(const ReplayBuffer *rb, long i, ReplayBatch *batch, int k) {
+    uint64_t before = __atomic_load_n(&rb->seq[i], __ATOMIC_ACQUIRE);
+    if (before == 0 || (before & 1)) return false;
+    batch->slot[k] = i;
+    batch->state[k] = __atomic_load_n(&rb->state[i], __ATOMIC_RELAXED);
+    batch->next[k] = __atomic_load_n(&rb->next[i], __ATOMIC_RELAXED);
+    batch->reward[k] = LoadF(&rb->reward[i]);
+    batch->action[k] = __atomic_load_n(&rb->action[i], __ATOMIC_RELAXED);
+    batch->done[k] = __atomic_load_n(&rb->done[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&rb->seq[i], __ATOMIC_RELAXED) == before;
+}
+
+// Ordena o minilote por estado (inserção: minilotes são pequenos)
+static void SortByState(ReplayBatch *b) {
+    for (int i = 1; i < b->n; i++) {
+        long slot = b->slot[i];
+        int state = b->state[i], next = b->next[i];
+        float reward = b->reward[i], weight = b->weight[i];
+        uint8_t action = b->action[i], done = b->done[i];
+        int j = i - 1;
+        while (j >= 0 && b->state[j] > state) {
+            b->slot[j + 1] = b->slot[j];
+            b->state[j + 1] = b->state[j];
+            b->next[j + 1] = b->next[j];
+            b->reward[j + 1] = b->reward[j];
+            b->weight[j + 1] = b->weight[j];
+            b->action[j + 1] = b->action[j];
+            b->done[j + 1] = b->done[j];
+            j--;
+        }
+        b->slot[j + 1] = slot;
+        b->state[j + 1] = state;
+        b->next[j + 1] = next;
+        b->reward[j + 1] = reward;
+        b->weight[j + 1] = weight;
+        b->action[j + 1] = action;
+        b->done[j + 1] = done;
+    }
+}
+
+int replay_sample(ReplayBuffer *rb, ReplayBatch *batch, int n, Rng *rng) {
+    batch->n = 0;
+    long size = replay_size(rb);
+    if (size == 0) return 0;
+    if (n > REPLAY_MAX_BATCH) n = REPLAY_MAX_BATCH;
+
+    const bool prioritized = rb->priorityAlpha > 0.0f;
+    const float maxPrio = LoadF(&rb->maxPriority);
+    float minPrio = maxPrio;
+    int k = 0;
+    for (int attempt = 0; k < n && attempt < 4 * n; attempt++) {
+        long i = (long)(((uint64_t)rng_next(rng) * (uint64_t)size) >> 32);
+        float p = 1.0f;
+        // Aceitação estocástica: proporcional à prioridade, sem árvore de somas.
+        // Esgotadas as tentativas fica a última posição testada, cuja
+        // prioridade é a que está em p (e vira o peso dela)
+        for (int t = 0; prioritized; t++) {
+            p = LoadF(&rb->priority[i]);
+            if (t == REPLAY_MAX_TRIES - 1 || rng_float(rng) * maxPrio < p) break;
+            i = (long)(((uint64_t)rng_next(rng) * (uint64_t)size) >> 32);
+        }
+        if (ReadSlot(rb, i, batch, k)) {
+            batch->weight[k] = p;
+            if (p < minPrio) minPrio = p;
+            k++;
+        }
+    }
+    batch->n = k;
+
+    // w_i = (N·P(i))^-beta dividido pelo maior peso do minilote: N e a soma
+    // das prioridades se cancelam e sobra (p_i / p_min)^-beta, em (0, 1]
+    const bool weighted = prioritized && rb->priorityBeta > 0.0f && minPrio > 0.0f;
+    for (int j = 0; j < k; j++) {
+        batch->weight[j] = weighted ? powf(batch->weight[j] / minPrio, -rb->priorityBeta) : 1.0f;
+    }
+    SortByState(batch);
+    return k;
+}
+
+// Maior prioridade entre as posições vivas (leitura sem lock, como a amostragem)
+static float LivePriorityMax(const ReplayBuffer *rb) {
+    long size = replay_size(rb);
+    float m = 0.0f;
+    for (long i = 0; i < size; i++) {
+        float p = LoadF(&rb->priority[i]);
+        if (p > m) m = p;
+    }
+    return m;
+}
+
+float replay_update(QTable *Q, ReplayBuffer *rb, const ReplayBatch *batch, float alpha, float gamma) {
+    const bool prioritized = rb->priorityAlpha > 0.0f;
+    float batchMax = 0.0f;
+    float sum = 0.0f;
+    for (int k = 0; k < batch->n; k++) {
+        float td = q_td_update(Q, batch->state[k], batch->action[k], batch->reward[k], batch->next[k],
+                               alpha * batch->weight[k], batch->done[k] ? 0.0f : gamma);
+        float err = fabsf(td);
+        sum += err;
+        if (prioritized) {
+            float p = powf(err + REPLAY_PRIORITY_EPS, rb->priorityAlpha);
+            StoreF(&rb->priority[batch->slot[k]], p);
+            if (p > batchMax) batchMax = p;
+        }
+    }
+    if (prioritized) {
+        // Máximo aproximado entre threads: só sobe entre recálculos; a cada
+        // capacity transições atualizadas quem cruza a marca varre o anel e
+        // baixa p_max para o máximo das prioridades vivas
+        long before = __atomic_fetch_add(&rb->updated, batch->n, __ATOMIC_RELAXED);
+        float maxPrio = LoadF(&rb->maxPriority);
+        if ((before + batch->n) / rb->capacity != before / rb->capacity) maxPrio = LivePriorityMax(rb);
+        if (batchMax > maxPrio) maxPrio = batchMax;
+        if (maxPrio > 0.0f) StoreF(&rb->maxPriority, maxPrio);
+    }
+    return batch->n > 0 ? sum / batch->n : 0.0f;
+}
@@ -0,0 +1,113 @@
+#ifndef REPLAYBUF_H
+#define REPLAYBUF_H
+
+#include "bot.h"
+#include "rng.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Buffer de experiência: anel de capacidade fixa com as transições
+ * (s, a, r, s', fim) em vetores SoA de um único bloco pré-alocado; empilhar
+ * uma transição nunca aloca. Vários atores podem escrever ao mesmo tempo sem
+ * locks: cada escrita reserva a posição com um fetch_add no cursor e publica
+ * o resultado por um contador de sequência (seqlock) da posição, que os
+ * leitores conferem para descartar posições sendo sobrescritas.
+ *
+ * A amostragem é uniforme ou priorizada pelo erro TD (aceitação estocástica:
+ * sorteia uma posição e aceita com probabilidade p_i / p_max). p_max é
+ * recalculado a partir das posições vivas a cada `capacity` transições
+ * atualizadas, para que a aceitação acompanhe as prioridades que caíram. O
+ * viés da priorização é corrigido por pesos de importância (N·P(i))^-beta,
+ * que escalam a taxa de aprendizado de cada transição. O minilote sai
+ * ordenado por estado, para que as atualizações da mesma linha da Q-table
+ * fiquem juntas.
+ */
+
+#define REPLAY_MAX_BATCH    256     // maior minilote aceito por replay_sample
+#define REPLAY_PRIORITY_EPS 0.01f   // prioridade mínima (nenhuma transição some)
+
+typedef struct {
+    long capacity;          // potência de 2
+    long cursor;            // transições já reservadas (contador global)
+    int *state, *next;
+    float *reward;
+    float *priority;        // (|TD| + eps)^alpha de cada posição
+    uint8_t *action, *done;
+    uint64_t *seq;          // seqlock: ímpar = escrevendo, 2(k+1) = k-ésima escrita publicada
+    float maxPriority;      // prioridade dada às transições novas e limite da aceitação
+    float priorityAlpha;    // expoente da prioridade (0 = amostragem uniforme)
+    float priorityBeta;     // expoente dos pesos de importância (1 = correção completa)
+    long updated;           // transições atualizadas (p_max é recalculado a cada capacity)
+    void *block;            // bloco único com todos os vetores
+} ReplayBuffer;
+
+// Minilote amostrado (cópia das transições, em SoA)
+typedef struct {
+    int n;
+    long slot[REPLAY_MAX_BATCH];
+    int state[REPLAY_MAX_BATCH];
+    int next[REPLAY_MAX_BATCH];
+    float reward[REPLAY_MAX_BATCH];
+    float weight[REPLAY_MAX_BATCH];     // peso de importância, normalizado pelo maior do minilote
+    uint8_t action[REPLAY_MAX_BATCH];
+    uint8_t done[REPLAY_MAX_BATCH];
+} ReplayBatch;
+
+/**
+ * Aloca o buffer.
+ * @param rb Buffer.
+ * @param capacity Número de transições (arredondado para potência de 2).
+ * @param priorityAlpha Expoente da priorização (0 = uniforme, 0.6 é usual).
+ * @param priorityBeta Expoente dos pesos de importância (0 = sem correção, 1 = completa).
+ * @return true se a alocação funcionou.
+ */
+bool replay_init(ReplayBuffer *rb, long capacity, float priorityAlpha, float priorityBeta);
+
+/**
+ * Libera o buffer.
+ * @param rb Buffer.
+ */
+void replay_free(ReplayBuffer *rb);
+
+/**
+ * Guarda uma transição, sobrescrevendo a mais antiga quando cheio.
+ * Pode ser chamada por várias threads ao mesmo tempo.
+ * @param rb Buffer.
+ * @param state Estado de origem.
+ * @param action Ação tomada.
+ * @param reward Recompensa recebida.
+ * @param next Estado seguinte.
+ * @param done Se a transição encerrou o episódio (alvo sem bootstrap).
+ */
+void replay_push(ReplayBuffer *rb, int state, int action, float reward, int next, bool done);
+
+/**
+ * Número de transições disponíveis (até a capacidade).
+ * @param rb Buffer.
+ */
+long replay_size(const ReplayBuffer *rb);
+
+/**
+ * Sorteia um minilote, ordenado por estado.
+ * @param rb Buffer.
+ * @param batch Saída.
+ * @param n Tamanho desejado (até REPLAY_MAX_BATCH).
+ * @param rng Gerador de quem amostra.
+ * @return Transições amostradas (menos que n se o buffer estiver vazio).
+ */
+int replay_sample(ReplayBuffer *rb, ReplayBatch *batch, int n, Rng *rng);
+
+/**
+ * Aplica o minilote na Q-table, com a taxa de aprendizado de cada transição
+ * escalada pelo seu peso de importância, e atualiza as prioridades das posições.
+ * @param Q Tabela Q.
+ * @param rb Buffer de onde o minilote veio.
+ * @param batch Minilote.
+ * @param alpha Taxa de aprendizado.
+ * @param gamma Fator de desconto.
+ * @return Média de |TD| do minilote.
+ */
+float replay_update(QTable *Q, ReplayBuffer *rb, const ReplayBatch *batch, float alpha, float gamma);
+
+#endif // REPLAYBUF_H
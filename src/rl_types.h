@@ -0,0 +1,31 @@
+#ifndef RL_TYPES_H
+#define RL_TYPES_H
+
+/*
+ * Subconjunto dos tipos do raylib usados pelo núcleo de simulação.
+ * Incluído por defs.h apenas no build headless (ARKANOID_HEADLESS), onde
+ * não há janela, áudio nem GPU. O layout é idêntico ao de raylib.h.
+ */
+
+#include <stdbool.h>
+
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+#endif // RL_TYPES_H
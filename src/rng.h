@@ -0,0 +1,97 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/*
+ * Gerador pseudoaleatório pequeno e explícito (xorshift64*).
+ * Cada jogo/agente carrega o seu próprio estado: não há estado global como
+ * em rand(), então threads diferentes nunca disputam o mesmo gerador.
+ */
+
+typedef struct {
+    uint64_t state;
+} Rng;
+
+/**
+ * Inicializa o gerador a partir de uma semente qualquer (inclusive 0).
+ * @param rng Gerador.
+ * @param seed Semente.
+ */
+static inline void rng_seed(Rng *rng, uint64_t seed) {
+    // splitmix64: espalha sementes próximas e nunca deixa o estado zerado
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    rng->state = z ? z : 0x9E3779B97F4A7C15ull;
+}
+
+/*
+ * Sequências derivadas de uma semente de execução: o ambiente i usa a
+ * sequência 2i para a física e 2i+1 para o agente. Como rng_seed passa a
+ * semente pelo splitmix64, sementes consecutivas geram estados independentes.
+ */
+
+/**
+ * Semente da física do ambiente de índice dado.
+ * @param seed Semente da execução.
+ * @param env Índice do ambiente (jogo do lote ou thread).
+ */
+static inline uint64_t rng_env_seed(uint64_t seed, int env) {
+    return seed + 2 * (uint64_t)env;
+}
+
+/**
+ * Semente do agente (exploração) do ambiente de índice dado.
+ * @param seed Semente da execução.
+ * @param env Índice do ambiente (jogo do lote ou thread).
+ */
+static inline uint64_t rng_agent_seed(uint64_t seed, int env) {
+    return seed + 2 * (uint64_t)env + 1;
+}
+
+/**
+ * Semente de execução para continuar um treino retomado no episódio dado,
+ * para não repetir as sequências dos episódios já vistos.
+ * @param seed Semente original da execução.
+ * @param episode Episódios já treinados (0 devolve a própria semente).
+ */
+static inline uint64_t rng_resume_seed(uint64_t seed, long episode) {
+    return seed ^ ((uint64_t)episode * 0x9E3779B97F4A7C15ull);
+}
+
+/**
+ * Próximo valor de 32 bits.
+ * @param rng Gerador.
+ * @return Inteiro uniforme em [0, 2^32).
+ */
+static inline uint32_t rng_next(Rng *rng) {
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+/**
+ * Float uniforme em [0, 1).
+ * @param rng Gerador.
+ */
+static inline float rng_float(Rng *rng) {
+    return (rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * Inteiro uniforme em [min, max] (mesma convenção de GetRandomValue).
+ * @param rng Gerador.
+ * @param min Limite inferior.
+ * @param max Limite superior.
+ */
+static inline int rng_range(Rng *rng, int min, int max) {
+    uint64_t span = (uint64_t)((int64_t)max - min + 1);
+    return min + (int)((rng_next(rng) * span) >> 32);
+}
+
+#endif // RNG_H
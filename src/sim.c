@@ -0,0 +1,343 @@
+#include "sim.h"
+#include "brick.h"
+#include "actionlog.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+static int ClampInt(int value, int min, int max)  {
+    if (value < min ) return min;
+    if (value > max ) return max;
+    return value;
+}
+
+void CreatePaddle(Rectangle *paddle) {
+    paddle->x = (SCREEN_W - PADDLE_W) / 2.0f;
+    paddle->y = SCREEN_H - 40;
+    paddle->width  = PADDLE_W;
+    paddle->height = PADDLE_H;
+}
+
+void CreateBall(Ball *ball, Rng *rng) {
+    ball->pos = (Vector2) { SCREEN_W / 2.0f, SCREEN_H / 2.0f };
+    ball->vel = (Vector2) { rng_range(rng, -240, 240), -240 };   // px/s
+    ball->radius = BALL_R;
+}
+
+void ExecuteAction(Rectangle *paddle, int action, float dt) {
+    switch(action) {
+        case ACTION_LEFT: // Mover para esquerda
+            paddle->x -= PADDLE_SPEED * dt;
+            break;
+        case ACTION_STAY: // Ficar parado
+            // Não faz nada
+            break;
+        case ACTION_RIGHT: // Mover para direita
+            paddle->x += PADDLE_SPEED * dt;
+            break;
+    }
+
+    // Manter paddle dentro da tela
+    paddle->x = ClampInt(paddle->x, 0, SCREEN_W - PADDLE_W);
+}
+
+// Calcula a recompensa baseada no estado atual do jogo
+float CalculateReward(Ball ball, Rectangle paddle, int score, int lastScore, bool gameOver, bool hitBrick) {
+    float reward = 0.0f;
+
+    if (gameOver) {
+        reward = -100.0f;  // Penalidade por perder
+    } else if (hitBrick) {
+        reward = 50.0f;    // Recompensa por quebrar tijolo
+    } else if (score > lastScore) {
+        reward = 10.0f;    // Recompensa por aumentar score
+    } else {
+        // Recompensa baseada na proximidade da bola com o paddle
+        float distance = fabsf(ball.pos.x - (paddle.x + PADDLE_W/2));
+        float normalized_distance = distance / (SCREEN_W/2);
+        reward = 1.0f - normalized_distance;  // Quanto mais próximo, maior a recompensa
+    }
+
+    return reward;
+}
+
+bool CheckCollisionBallRec(Vector2 center, float radius, Rectangle rec) {
+    // Ponto do retângulo mais próximo do centro do círculo
+    float cx = fmaxf(rec.x, fminf(center.x, rec.x + rec.width));
+    float cy = fmaxf(rec.y, fminf(center.y, rec.y + rec.height));
+    float dx = center.x - cx;
+    float dy = center.y - cy;
+    return (dx*dx + dy*dy) <= radius*radius;
+}
+
+bool SweepBallRec(Vector2 center, Vector2 vel, float radius, Rectangle rec, float tMax, float *t, Vector2 *normal) {
+    // Raio contra o retângulo expandido pelo raio (método das placas)
+    float lo[2] = { rec.x - radius, rec.y - radius };
+    float hi[2] = { rec.x + rec.width + radius, rec.y + rec.height + radius };
+    float p[2] = { center.x, center.y };
+    float v[2] = { vel.x, vel.y };
+    float tEnter = -INFINITY, tExit = INFINITY;
+    Vector2 n = { 0.0f, 0.0f };
+    for (int axis = 0; axis < 2; axis++) {
+        if (v[axis] == 0.0f) {
+            if (p[axis] < lo[axis] || p[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t0 = (lo[axis] - p[axis]) / v[axis];
+        float t1 = (hi[axis] - p[axis]) / v[axis];
+        float side = -1.0f;     // entrando pela face de menor coordenada
+        if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; side = 1.0f; }
+        if (t0 > tEnter) {
+            tEnter = t0;
+            n = (axis == 0) ? (Vector2){ side, 0.0f } : (Vector2){ 0.0f, side };
+        }
+        if (t1 < tExit) tExit = t1;
+    }
+    if (tEnter > tExit || tExit <= 0.0f || tEnter > tMax) return false;
+    if (vel.x * n.x + vel.y * n.y >= 0.0f) return false;   // já se afastando
+    float tHit = tEnter > 0.0f ? tEnter : 0.0f;
+
+    // Contato fora das faces originais: na verdade o alvo é o canto arredondado
+    float hx = center.x + vel.x * tHit;
+    float hy = center.y + vel.y * tHit;
+    bool outX = hx < rec.x || hx > rec.x + rec.width;
+    bool outY = hy < rec.y || hy > rec.y + rec.height;
+    if (outX && outY) {
+        Vector2 corner = { hx < rec.x ? rec.x : rec.x + rec.width,
+                           hy < rec.y ? rec.y : rec.y + rec.height };
+        float mx = center.x - corner.x, my = center.y - corner.y;
+        float a = vel.x * vel.x + vel.y * vel.y;
+        float b = mx * vel.x + my * vel.y;
+        float c = mx * mx + my * my - radius * radius;
+        if (b >= 0.0f) return false;            // afastando-se do canto
+        if (c <= 0.0f) {
+            tHit = 0.0f;                        // já encostado no canto
+        } else {
+            float disc = b * b - a * c;
+            if (disc < 0.0f) return false;      // passa ao lado do canto
+            tHit = (-b - sqrtf(disc)) / a;
+            if (tHit > tMax) return false;
+        }
+        float nx = center.x + vel.x * tHit - corner.x;
+        float ny = center.y + vel.y * tHit - corner.y;
+        float len = sqrtf(nx * nx + ny * ny);
+        if (len > 0.0f) n = (Vector2){ nx / len, ny / len };
+    }
+    *t = tHit;
+    *normal = n;
+    return true;
+}
+
+// O que a bola atinge primeiro em um trecho do movimento contínuo
+enum { HIT_NONE, HIT_WALL, HIT_PADDLE, HIT_BRICK };
+
+// Move a bola por um passo inteiro resolvendo cada impacto no seu instante
+static unsigned MoveBallSwept(SimState *sim) {
+    unsigned events = 0;
+    Ball *ball = &sim->ball;
+    const Rectangle *paddle = &sim->paddle;
+    const float r = ball->radius;
+    float left = sim->dt;
+
+    for (int bounce = 0; bounce <= SIM_MAX_BOUNCES && left > 0.0f; bounce++) {
+        float best = left;
+        int what = HIT_NONE;
+        Vector2 n = { 0.0f, 0.0f };
+        int row = 0, col = 0;
+
+        // Paredes (a base é aberta)
+        if (ball->vel.x < 0.0f) {
+            float t = (r - ball->pos.x) / ball->vel.x;
+            if (t < 0.0f) t = 0.0f;
+            if (t < best) { best = t; what = HIT_WALL; n = (Vector2){ 1.0f, 0.0f }; }
+        } else if (ball->vel.x > 0.0f) {
+            float t = (SCREEN_W - r - ball->pos.x) / ball->vel.x;
+            if (t < 0.0f) t = 0.0f;
+            if (t < best) { best = t; what = HIT_WALL; n = (Vector2){ -1.0f, 0.0f }; }
+        }
+        if (ball->vel.y < 0.0f) {
+            float t = (r - ball->pos.y) / ball->vel.y;
+            if (t < 0.0f) t = 0.0f;
+            if (t < best) { best = t; what = HIT_WALL; n = (Vector2){ 0.0f, 1.0f }; }
+        }
+
+        float t;
+        Vector2 hitNormal;
+        // O paddle só rebate bolas descendo (uma bola subindo já foi rebatida,
+        // mesmo que o paddle tenha se movido para cima dela)
+        if (ball->vel.y > 0.0f && SweepBallRec(ball->pos, ball->vel, r, *paddle, best, &t, &hitNormal) && t < best) {
+            best = t;
+            what = HIT_PADDLE;
+        }
+        if (SweepBricks(sim->level, sim->bricks.alive, ball->pos, ball->vel, r, best, &t, &hitNormal, &row, &col)
+            && t < best) {
+            best = t;
+            what = HIT_BRICK;
+            n = hitNormal;
+        }
+
+        ball->pos.x += ball->vel.x * best;
+        ball->pos.y += ball->vel.y * best;
+        left -= best;
+
+        if (what == HIT_NONE || bounce == SIM_MAX_BOUNCES) break;
+        if (what == HIT_PADDLE) {
+            // Mesma regra do modo discreto: sobe e o desvio depende do ponto de contato
+            events |= SIM_EVENT_PADDLE_HIT;
+            ball->vel.y = -fabsf(ball->vel.y);
+            float hit = (ball->pos.x - (paddle->x + PADDLE_W / 2.0f)) / (PADDLE_W / 2.0f);
+            ball->vel.x = 300 * hit;
+            continue;
+        }
+        if (what == HIT_BRICK) {
+            if (HitBrick(sim->level, &sim->bricks, row, col)) sim->score += 10;
+            events |= SIM_EVENT_BRICK_HIT;
+        }
+        // Reflexão pela normal (nas faces equivale a inverter um eixo)
+        float dot = ball->vel.x * n.x + ball->vel.y * n.y;
+        ball->vel.x -= 2.0f * dot * n.x;
+        ball->vel.y -= 2.0f * dot * n.y;
+    }
+
+    if (ball->pos.y >= SCREEN_H + r) {
+        if (!sim->gameOver) events |= SIM_EVENT_GAME_OVER;
+        sim->gameOver = true;
+    }
+    return events;
+}
+
+void sim_init(SimState *sim, float dt, uint64_t seed) {
+    sim->dt = (dt > 0.0f) ? dt : SIM_DT;
+    sim->collision = SIM_COLLISION_DISCRETE;
+    sim->log = NULL;
+    sim->level = level_builtin();
+    rng_seed(&sim->rng, seed);
+    sim_reset(sim);
+}
+
+void sim_reset(SimState *sim) {
+    CreateBall(&sim->ball, &sim->rng);
+    CreatePaddle(&sim->paddle);
+    level_reset(sim->level, &sim->bricks);
+    sim->score = 0;
+    sim->gameOver = false;
+}
+
+void sim_set_level(SimState *sim, const Level *level) {
+    sim->level = level ? level : level_builtin();
+    level_reset(sim->level, &sim->bricks);
+}
+
+unsigned sim_step(SimState *sim, int action) {
+    unsigned events = 0;
+    Ball *ball = &sim->ball;
+    Rectangle *paddle = &sim->paddle;
+    float dt = sim->dt;
+
+    if (sim->log) actionlog_push(sim->log, action);
+    ExecuteAction(paddle, action, dt);
+    if (sim->collision == SIM_COLLISION_SWEPT) return MoveBallSwept(sim);
+
+    // Movimento da bola
+    ball->pos.x += ball->vel.x * dt;
+    ball->pos.y += ball->vel.y * dt;
+
+    // Colisões com bordas
+    if (ball->pos.x <= ball->radius || ball->pos.x >= SCREEN_W - ball->radius)
+        ball->vel.x *= -1.0f;
+    if (ball->pos.y <= ball->radius)
+        ball->vel.y *= -1.0f;
+    if (ball->pos.y >= SCREEN_H + ball->radius) {
+        if (!sim->gameOver) events |= SIM_EVENT_GAME_OVER;
+        sim->gameOver = true;
+    }
+
+    // Colisão com paddle
+    if (CheckCollisionBallRec(ball->pos, ball->radius, *paddle)) {
+        events |= SIM_EVENT_PADDLE_HIT;
+        ball->vel.y = -fabsf(ball->vel.y);
+        float hit = (ball->pos.x - (paddle->x + PADDLE_W / 2.0f)) / (PADDLE_W / 2.0f);
+        ball->vel.x = 300 * hit;
+    }
+
+    // Colisões com tijolos
+    if (CreateBricks(sim->level, &sim->bricks, ball, &sim->score))
+        events |= SIM_EVENT_BRICK_HIT;
+
+    return events;
+}
+
+// Acumula n bytes no hash FNV-1a
+static uint64_t HashBytes(uint64_t h, const void *data, size_t n) {
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+// Palavras por plano do BrickField e planos usados pelo nível
+static size_t FieldWords(const Level *level) {
+    return (size_t)level->rows * level->words;
+}
+
+static int FieldPlanes(const Level *level) {
+    return level->multiHit ? 1 + LEVEL_HP_BITS : 1;
+}
+
+size_t sim_pack_size(const Level *level) {
+    return offsetof(SimState, bricks) + FieldPlanes(level) * FieldWords(level) * sizeof(uint64_t);
+}
+
+void sim_pack(const SimState *sim, void *dst) {
+    unsigned char *out = (unsigned char *)dst;
+    size_t bytes = FieldWords(sim->level) * sizeof(uint64_t);
+    int planes = FieldPlanes(sim->level);
+    memcpy(out, sim, offsetof(SimState, bricks));
+    out += offsetof(SimState, bricks);
+    memcpy(out, sim->bricks.alive, bytes);
+    for (int p = 1; p < planes; p++) memcpy(out + p * bytes, sim->bricks.hits[p - 1], bytes);
+}
+
+void sim_unpack(SimState *sim, const void *src) {
+    const unsigned char *in = (const unsigned char *)src;
+    memcpy(sim, in, offsetof(SimState, bricks));
+    in += offsetof(SimState, bricks);
+    size_t bytes = FieldWords(sim->level) * sizeof(uint64_t);
+    int planes = FieldPlanes(sim->level);
+    memcpy(sim->bricks.alive, in, bytes);
+    for (int p = 1; p < planes; p++) memcpy(sim->bricks.hits[p - 1], in + p * bytes, bytes);
+}
+
+uint64_t sim_hash(const SimState *sim) {
+    // Campo a campo: o padding das structs não entra no resumo
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = HashBytes(h, &sim->paddle.x, sizeof(float));
+    h = HashBytes(h, &sim->paddle.y, sizeof(float));
+    h = HashBytes(h, &sim->ball.pos.x, sizeof(float));
+    h = HashBytes(h, &sim->ball.pos.y, sizeof(float));
+    h = HashBytes(h, &sim->ball.vel.x, sizeof(float));
+    h = HashBytes(h, &sim->ball.vel.y, sizeof(float));
+    // Níveis de até 64 tijolos entram num só uint64_t (bit r * cols + c), como
+    // sempre foi com o nível embutido; os maiores, palavra a palavra
+    const Level *level = sim->level;
+    int words = level->rows * level->words;
+    if (level->rows * level->cols <= 64) {
+        uint64_t alive = 0;
+        for (int r = 0; r < level->rows; ++r)
+            alive |= sim->bricks.alive[r * level->words] << (r * level->cols);
+        h = HashBytes(h, &alive, sizeof(alive));
+    } else {
+        h = HashBytes(h, sim->bricks.alive, (size_t)words * sizeof(uint64_t));
+    }
+    if (level->multiHit) {
+        for (int p = 0; p < LEVEL_HP_BITS; p++) h = HashBytes(h, sim->bricks.hits[p], (size_t)words * sizeof(uint64_t));
+    }
+    int32_t score = sim->score;
+    unsigned char over = sim->gameOver ? 1 : 0;
+    h = HashBytes(h, &score, sizeof(score));
+    h = HashBytes(h, &over, sizeof(over));
+    h = HashBytes(h, &sim->rng.state, sizeof(sim->rng.state));
+    return h;
+}
@@ -0,0 +1,172 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "defs.h"
+#include "rng.h"
+#include "level.h"
+
+/*
+ * Núcleo de simulação do Arkanoid, independente de janela, áudio e GPU.
+ * A física avança em passos de tamanho fixo; quem chama (loop da janela,
+ * treino headless) decide quantos passos dar e o que fazer com os eventos.
+ */
+
+// Passo fixo padrão da simulação (em segundos)
+#define SIM_DT        (1.0f / 60.0f)
+
+// Velocidade horizontal do paddle (px/s)
+#define PADDLE_SPEED  450.0f
+
+// Ações do agente/jogador
+#define ACTION_LEFT   0
+#define ACTION_STAY   1
+#define ACTION_RIGHT  2
+
+// Detecção de colisão da bola
+#define SIM_COLLISION_DISCRETE  0   // move e testa sobreposição (padrão, igual ao lote)
+#define SIM_COLLISION_SWEPT     1   // contínua: tempo de impacto, vários quiques por passo
+
+// Máximo de quiques resolvidos em um passo no modo contínuo
+#define SIM_MAX_BOUNCES 8
+
+// Eventos produzidos por um passo (bitmask)
+#define SIM_EVENT_PADDLE_HIT  (1u << 0)
+#define SIM_EVENT_BRICK_HIT   (1u << 1)
+#define SIM_EVENT_GAME_OVER   (1u << 2)
+
+struct ActionLog;
+
+// Estado completo de um jogo
+typedef struct {
+    Rectangle paddle;
+    Ball ball;
+    const Level *level;         // imagem do nível (compartilhável, só leitura)
+    int score;
+    bool gameOver;
+    float dt;       // tamanho do passo fixo
+    int collision;  // SIM_COLLISION_DISCRETE ou SIM_COLLISION_SWEPT
+    Rng rng;        // gerador do próprio jogo (direção inicial da bola)
+    struct ActionLog *log;  // se não for NULL, sim_step grava cada ação aplicada
+    BrickField bricks;      // tijolos vivos e acertos; por último, ver sim_pack
+} SimState;
+
+/**
+ * Posiciona o paddle no centro, na parte de baixo da tela.
+ * @param paddle Paddle a ser inicializado.
+ */
+void CreatePaddle(Rectangle *paddle);
+
+/**
+ * Coloca a bola no centro da tela com velocidade horizontal aleatória.
+ * @param ball Bola a ser inicializada.
+ * @param rng Gerador usado para sortear a direção.
+ */
+void CreateBall(Ball *ball, Rng *rng);
+
+/**
+ * Move o paddle de acordo com a ação e o mantém dentro da tela.
+ * @param paddle Paddle a ser movido.
+ * @param action ACTION_LEFT, ACTION_STAY ou ACTION_RIGHT.
+ * @param dt Intervalo de tempo do passo.
+ */
+void ExecuteAction(Rectangle *paddle, int action, float dt);
+
+/**
+ * Calcula a recompensa do agente para a transição mais recente.
+ * @param ball Bola após o passo.
+ * @param paddle Paddle após o passo.
+ * @param score Pontuação após o passo.
+ * @param lastScore Pontuação antes do passo.
+ * @param gameOver Se o passo terminou o episódio.
+ * @param hitBrick Se algum tijolo foi atingido no passo.
+ * @return Recompensa escalar.
+ */
+float CalculateReward(Ball ball, Rectangle paddle, int score, int lastScore, bool gameOver, bool hitBrick);
+
+/**
+ * Teste de colisão círculo-retângulo (mesma semântica de CheckCollisionCircleRec
+ * do raylib, disponível também no build headless).
+ */
+bool CheckCollisionBallRec(Vector2 center, float radius, Rectangle rec);
+
+/**
+ * Varredura de um círculo em movimento retilíneo contra um retângulo (a
+ * soma de Minkowski é o retângulo com cantos arredondados de raio radius).
+ * Contatos em que a bola já se afasta do retângulo são ignorados.
+ * @param center Centro no início do movimento.
+ * @param vel Velocidade (px/s).
+ * @param radius Raio do círculo.
+ * @param rec Retângulo parado.
+ * @param tMax Tempo máximo considerado.
+ * @param t Saída: tempo do primeiro contato, em [0, tMax].
+ * @param normal Saída: normal unitária do retângulo no ponto de contato.
+ * @return true se houve contato até tMax.
+ */
+bool SweepBallRec(Vector2 center, Vector2 vel, float radius, Rectangle rec, float tMax, float *t, Vector2 *normal);
+
+/**
+ * Inicializa a simulação com o passo fixo dado e começa um jogo novo no
+ * nível embutido.
+ * @param sim Estado da simulação.
+ * @param dt Tamanho do passo em segundos (<= 0 usa SIM_DT).
+ * @param seed Semente do gerador do jogo.
+ */
+void sim_init(SimState *sim, float dt, uint64_t seed);
+
+/**
+ * Reinicia o jogo: bola, paddle, tijolos e pontuação. Mantém o passo fixo.
+ * @param sim Estado da simulação.
+ */
+void sim_reset(SimState *sim);
+
+/**
+ * Troca o nível e recoloca todos os tijolos dele, sem mexer em bola, paddle
+ * e gerador (chamar logo depois de sim_init não altera a sequência do jogo).
+ * @param sim Estado da simulação.
+ * @param level Nível (NULL = embutido); precisa viver enquanto a simulação o usar.
+ */
+void sim_set_level(SimState *sim, const Level *level);
+
+/**
+ * Avança a simulação em um passo fixo de sim->dt segundos. No modo
+ * SIM_COLLISION_SWEPT a bola não atravessa tijolos nem o paddle mesmo com
+ * passos grandes: cada impacto é resolvido no seu instante exato.
+ * @param sim Estado da simulação.
+ * @param action Ação aplicada ao paddle neste passo.
+ * @return Bitmask de SIM_EVENT_* ocorridos no passo.
+ */
+unsigned sim_step(SimState *sim, int action);
+
+/**
+ * Bytes de um jogo empacotado com sim_pack: o estado sem o BrickField mais
+ * as rows × words palavras que o nível usa (de vivos e, se multiHit, de cada
+ * plano de acertos), em vez dos ~6 KB do campo de tamanho máximo.
+ * @param level Nível do jogo.
+ */
+size_t sim_pack_size(const Level *level);
+
+/**
+ * Empacota o jogo em sim_pack_size(sim->level) bytes.
+ * @param sim Estado da simulação.
+ * @param dst Destino.
+ */
+void sim_pack(const SimState *sim, void *dst);
+
+/**
+ * Restaura um jogo empacotado com sim_pack. As palavras do BrickField fora
+ * do nível ficam como estavam (nunca são lidas).
+ * @param sim Estado da simulação.
+ * @param src Jogo empacotado.
+ */
+void sim_unpack(SimState *sim, const void *src);
+
+/**
+ * Resumo (FNV-1a) do estado observável do jogo: paddle, bola, tijolos vivos,
+ * pontuação e gerador. Duas execuções com a mesma semente e as mesmas ações
+ * produzem o mesmo valor, bit a bit.
+ * @param sim Estado da simulação.
+ * @return Hash de 64 bits.
+ */
+uint64_t sim_hash(const SimState *sim);
+
+#endif // SIM_H
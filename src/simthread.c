@@ -0,0 +1,98 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "simthread.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static void SleepUntil(double when) {
+    double s = when - snapshot_now();
+    if (s <= 0.0) return;
+    struct timespec ts = { (time_t)s, (long)((s - (time_t)s) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+static void Publish(SimThread *st) {
+    snapshot_capture(snapshot_write_slot(&st->snapshots), st->sim, st->episode, st->epsilon);
+    snapshot_publish(&st->snapshots);
+}
+
+// Fim de episódio: mesmas contas do loop da janela no modo de treino
+static void EndEpisode(SimThread *st, TrainEpisodeStats *stats, long *windowScore, int *windowEpisodes) {
+    int score = st->sim->score;
+    st->episode++;
+    telemetry_episode(st->telemetry, stats, score, st->epsilon);
+    memset(stats, 0, sizeof(*stats));
+
+    *windowScore += score;
+    if (++*windowEpisodes == SIMTHREAD_REPORT_EVERY) {
+        printf("Episódio %ld - Score médio: %.2f - Epsilon: %.3f\n", st->episode,
+               (float)*windowScore / *windowEpisodes, st->epsilon);
+        *windowScore = 0;
+        *windowEpisodes = 0;
+    }
+
+    // O checkpoint guarda o gerador de antes do lançamento da bola, como o
+    // headless: quem retoma faz o mesmo sim_reset e sorteia a mesma bola
+    uint64_t simRng = st->sim->rng.state;
+    sim_reset(st->sim);
+    st->epsilon = train_decay_epsilon(&st->params, st->epsilon);
+    if (st->checkpoint && st->checkpointEvery > 0 && st->episode % st->checkpointEvery == 0) {
+        QTableMeta meta;
+        memset(&meta, 0, sizeof(meta));
+        meta.alpha = st->params.alpha;
+        meta.gamma = st->params.gamma;
+        meta.epsilon = st->epsilon;
+        meta.episodes = st->episode;
+        meta.steps = st->trainSteps;
+        meta.seed = st->seed;
+        meta.simRng = simRng;
+        meta.agentRng = st->rng->state;
+        checkpoint_submit(st->checkpoint, st->Q, &meta, false);
+    }
+}
+
+static void *SimThreadMain(void *arg) {
+    SimThread *st = (SimThread *)arg;
+    TrainEpisodeStats stats;
+    memset(&stats, 0, sizeof(stats));
+    long windowScore = 0;
+    int windowEpisodes = 0;
+    double next = snapshot_now();
+
+    while (!__atomic_load_n(&st->quit, __ATOMIC_RELAXED)) {
+        if (st->sim->gameOver) EndEpisode(st, &stats, &windowScore, &windowEpisodes);
+
+        bool realtime = __atomic_load_n(&st->realtime, __ATOMIC_RELAXED);
+        if (realtime) {
+            next += st->sim->dt;
+            SleepUntil(next);
+        } else {
+            next = snapshot_now();
+        }
+
+        train_step(st->Q, st->sim, st->epsilon, st->params.alpha, st->params.gamma, st->rng, &stats);
+        stats.steps++;
+        st->steps++;
+        st->trainSteps++;
+        if (realtime || st->steps % SIMTHREAD_PUBLISH_EVERY == 0 || st->sim->gameOver) Publish(st);
+    }
+    return NULL;
+}
+
+bool simthread_start(SimThread *st) {
+    st->quit = false;
+    st->steps = 0;
+    snapshot_init(&st->snapshots);
+    Publish(st);
+    return pthread_create(&st->thread, NULL, SimThreadMain, st) == 0;
+}
+
+void simthread_set_realtime(SimThread *st, bool realtime) {
+    __atomic_store_n(&st->realtime, realtime, __ATOMIC_RELAXED);
+}
+
+void simthread_stop(SimThread *st) {
+    __atomic_store_n(&st->quit, true, __ATOMIC_RELAXED);
+    pthread_join(st->thread, NULL);
+}
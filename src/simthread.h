@@ -0,0 +1,68 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include "train.h"
+#include "snapshot.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include <pthread.h>
+#include <stdbool.h>
+
+/*
+ * Treino numa thread própria, desacoplado do desenho. Enquanto a thread
+ * roda, ela é dona da simulação, da Q-table e do gerador passados em
+ * simthread_start; quem desenha só lê os retratos publicados no buffer
+ * triplo. simthread_stop devolve tudo (com epsilon e episódio atualizados).
+ *
+ * Em velocidade máxima um retrato sai a cada SIMTHREAD_PUBLISH_EVERY passos;
+ * em tempo real a thread dorme até o próximo passo e publica todos.
+ */
+
+#define SIMTHREAD_PUBLISH_EVERY 64      // passos entre retratos (velocidade máxima)
+#define SIMTHREAD_REPORT_EVERY 100      // episódios por linha de score médio
+
+typedef struct {
+    // Entrada (dona da thread entre start e stop)
+    QTable *Q;
+    SimState *sim;
+    Rng *rng;
+    TrainParams params;
+    float epsilon;              // atualizado pela thread
+    long episode;               // episódios de treino concluídos
+    long trainSteps;            // passos de treino acumulados (atualizado pela thread)
+    uint64_t seed;              // semente (metadados de checkpoint)
+    Checkpointer *checkpoint;   // pode ser NULL
+    long checkpointEvery;
+    TelemetrySlot *telemetry;   // pode ser NULL
+
+    // Controle e saída
+    bool realtime;              // um passo a cada sim->dt (escrito por quem chama)
+    bool quit;
+    long steps;                 // passos dados desde start
+    SnapshotBuffer snapshots;
+    pthread_t thread;
+} SimThread;
+
+/**
+ * Publica o estado atual e inicia a thread de treino. Os campos de entrada
+ * já devem estar preenchidos.
+ * @param st Thread.
+ * @return true se a thread foi criada.
+ */
+bool simthread_start(SimThread *st);
+
+/**
+ * Liga ou desliga o passo em tempo real (vale a partir do próximo passo).
+ * @param st Thread.
+ * @param realtime true para um passo a cada sim->dt.
+ */
+void simthread_set_realtime(SimThread *st, bool realtime);
+
+/**
+ * Para a thread e espera ela terminar; a simulação, a Q-table, epsilon e
+ * episode voltam para quem chamou.
+ * @param st Thread.
+ */
+void simthread_stop(SimThread *st);
+
+#endif // SIMTHREAD_H
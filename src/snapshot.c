@@ -0,0 +1,46 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "snapshot.h"
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+double snapshot_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void snapshot_init(SnapshotBuffer *b) {
+    memset(b, 0, sizeof(*b));
+    b->back = 0;
+    b->middle = 1;
+    b->front = 2;
+}
+
+void snapshot_capture(SimSnapshot *s, const SimState *sim, long episode, float epsilon) {
+    s->paddle = sim->paddle;
+    s->ball = sim->ball;
+    s->level = sim->level;
+    memcpy(s->bricks, sim->bricks.alive, (size_t)sim->level->rows * sim->level->words * sizeof(uint64_t));
+    s->score = sim->score;
+    s->gameOver = sim->gameOver;
+    s->episode = episode;
+    s->epsilon = epsilon;
+    s->time = snapshot_now();
+}
+
+void snapshot_copy(SimSnapshot *dst, const SimSnapshot *src) {
+    size_t words = src->level ? (size_t)src->level->rows * src->level->words : 0;
+    memcpy(dst, src, offsetof(SimSnapshot, bricks));
+    memcpy(dst->bricks, src->bricks, words * sizeof(uint64_t));
+}
+
+void snapshot_lerp(SimSnapshot *out, const SimSnapshot *from, const SimSnapshot *to, float t) {
+    snapshot_copy(out, to);
+    // Entre episódios (ou no game over) a bola salta: sem interpolação
+    if (from->episode != to->episode || from->gameOver || to->gameOver) return;
+    out->ball.pos.x = from->ball.pos.x + (to->ball.pos.x - from->ball.pos.x) * t;
+    out->ball.pos.y = from->ball.pos.y + (to->ball.pos.y - from->ball.pos.y) * t;
+    out->paddle.x = from->paddle.x + (to->paddle.x - from->paddle.x) * t;
+}
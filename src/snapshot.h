@@ -0,0 +1,107 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "sim.h"
+#include <stdint.h>
+
+/*
+ * Retratos da simulação para quem só desenha. O produtor (thread de
+ * simulação) escreve num buffer triplo sem locks: ele sempre tem um slot
+ * próprio para escrever, o consumidor sempre tem um slot próprio para ler, e
+ * o terceiro (o do meio) é trocado atomicamente. Nenhum dos lados espera o
+ * outro; o consumidor vê sempre o retrato mais recente completo.
+ */
+
+// Bit do índice do meio: o slot foi publicado e ainda não foi lido
+#define SNAPSHOT_FRESH 4
+
+// Estado necessário para desenhar um quadro
+typedef struct {
+    Rectangle paddle;
+    Ball ball;
+    const Level *level;         // geometria e cores dos tijolos
+    int score;
+    bool gameOver;
+    long episode;               // episódio de treino em andamento
+    float epsilon;
+    double time;                // instante da captura (CLOCK_MONOTONIC, s)
+    uint64_t seq;               // número da publicação
+    uint64_t bricks[LEVEL_FIELD_WORDS]; // tijolos vivos; por último: só rows × words palavras são válidas e copiadas
+} __attribute__((aligned(64))) SimSnapshot;
+
+typedef struct {
+    SimSnapshot slots[3];
+    int back;                   // slot do produtor
+    int front;                  // slot do consumidor
+    int middle;                 // slot trocado atomicamente (| SNAPSHOT_FRESH)
+    uint64_t published;         // publicações feitas (só o produtor escreve)
+} SnapshotBuffer;
+
+/**
+ * Relógio dos retratos (CLOCK_MONOTONIC, em segundos).
+ */
+double snapshot_now(void);
+
+/**
+ * Prepara o buffer (slots zerados, nenhum retrato novo).
+ * @param b Buffer.
+ */
+void snapshot_init(SnapshotBuffer *b);
+
+/**
+ * Copia o estado observável do jogo para um retrato.
+ * @param s Retrato.
+ * @param sim Simulação.
+ * @param episode Episódio de treino.
+ * @param epsilon Exploração atual.
+ */
+void snapshot_capture(SimSnapshot *s, const SimState *sim, long episode, float epsilon);
+
+/**
+ * Copia um retrato levando só as palavras de tijolos que o nível usa (a
+ * cópia de estrutura inteira moveria LEVEL_FIELD_WORDS palavras).
+ * @param dst Destino.
+ * @param src Origem (level pode ser NULL num retrato zerado).
+ */
+void snapshot_copy(SimSnapshot *dst, const SimSnapshot *src);
+
+/**
+ * Slot em que o produtor escreve o próximo retrato.
+ * @param b Buffer.
+ */
+static inline SimSnapshot *snapshot_write_slot(SnapshotBuffer *b) {
+    return &b->slots[b->back];
+}
+
+/**
+ * Publica o slot escrito e passa a escrever no que estava no meio.
+ * @param b Buffer.
+ */
+static inline void snapshot_publish(SnapshotBuffer *b) {
+    b->slots[b->back].seq = ++b->published;
+    b->back = __atomic_exchange_n(&b->middle, b->back | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL) & 3;
+}
+
+/**
+ * Retrato mais recente (pega o do meio se houver um novo).
+ * @param b Buffer.
+ * @return Retrato do consumidor, válido até a próxima chamada.
+ */
+static inline const SimSnapshot *snapshot_latest(SnapshotBuffer *b) {
+    if (__atomic_load_n(&b->middle, __ATOMIC_RELAXED) & SNAPSHOT_FRESH) {
+        b->front = __atomic_exchange_n(&b->middle, b->front, __ATOMIC_ACQ_REL) & 3;
+    }
+    return &b->slots[b->front];
+}
+
+/**
+ * Interpola bola e paddle entre dois retratos do mesmo episódio; tijolos,
+ * pontuação e o restante vêm de `to`.
+ * @param out Saída.
+ * @param from Retrato anterior.
+ * @param to Retrato mais novo.
+ * @param t Fração em [0, 1] (0 = from, 1 = to).
+ */
+void snapshot_lerp(SimSnapshot *out, const SimSnapshot *from, const SimSnapshot *to, float t);
+
+#endif // SNAPSHOT_H
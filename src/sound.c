@@ -1,25 +1,95 @@
 #include <raylib.h>
+#include <stdint.h>
+#include "sound.h"
+#include "assets.h"
 
-// Sons do jogo
-Sound paddleHitSound;
-Sound brickHitSound;
-Sound gameOverSound;
-Sound restartSound;
+// Nome de cada som entre os embutidos (assets/sounds/<nome>.wav)
+static const char *soundNames[SFX_COUNT] = {
+    "paddle_hit",
+    "brick_hit",
+    "game_over",
+    "restart",
+};
+
+typedef char SoundQueuePow2Check[(SOUND_QUEUE_SIZE & (SOUND_QUEUE_SIZE - 1)) == 0 ? 1 : -1];
+
+// Sons do jogo: a voz 0 é o som carregado, as outras são aliases dele
+static Sound voices[SFX_COUNT][SOUND_VOICES];
+static int voiceCount[SFX_COUNT];
+static bool soundEnabled;
+static bool audioOpened;        // o dispositivo foi aberto aqui (e é fechado em UnloadSounds)
+
+// Fila circular de um produtor e um consumidor
+static uint8_t queue[SOUND_QUEUE_SIZE];
+static unsigned queueHead;      // escrito só por QueueSound
+static unsigned queueTail;      // escrito só por PlayQueuedSounds
+
+// Abre o dispositivo e cria as vozes a partir do PCM embutido (sem ler arquivos)
+static bool OpenAudio(void) {
+    InitAudioDevice();
+    if (!IsAudioDeviceReady()) return false;
+    audioOpened = true;
+    for (int s = 0; s < SFX_COUNT; s++) {
+        const EmbeddedSound *pcm = assets_sound(soundNames[s]);
+        if (!pcm || pcm->frameCount == 0) continue;    // som ausente do build: mudo
+        Wave wave = { pcm->frameCount, pcm->sampleRate, pcm->sampleSize, pcm->channels, (void *)pcm->data };
+        voices[s][0] = LoadSoundFromWave(wave);
+        if (!IsSoundReady(voices[s][0])) continue;
+        voiceCount[s] = 1;
+        for (int v = 1; v < SOUND_VOICES; v++) voices[s][voiceCount[s]++] = LoadSoundAlias(voices[s][0]);
+    }
+    return true;
+}
 
 // Função para carregar os sons
-void LoadSounds(void) {
-    paddleHitSound = LoadSound("assets/sounds/paddle_hit.wav");
-    brickHitSound = LoadSound("assets/sounds/brick_hit.wav");
-    gameOverSound = LoadSound("assets/sounds/game_over.wav");
-    restartSound = LoadSound("assets/sounds/restart.wav");
+void LoadSounds(bool enabled) {
+    // O dispositivo só é aberto no primeiro som de fato pedido
+    soundEnabled = enabled;
+    queueHead = queueTail = 0;
+    for (int s = 0; s < SFX_COUNT; s++) voiceCount[s] = 0;
 }
 
 // Função para descarregar os sons
 void UnloadSounds(void) {
-    UnloadSound(paddleHitSound);
-    UnloadSound(brickHitSound);
-    UnloadSound(gameOverSound);
-    UnloadSound(restartSound);
+    for (int s = 0; s < SFX_COUNT; s++) {
+        for (int v = 1; v < voiceCount[s]; v++) UnloadSoundAlias(voices[s][v]);
+        if (voiceCount[s] > 0) UnloadSound(voices[s][0]);
+        voiceCount[s] = 0;
+    }
+    if (audioOpened) CloseAudioDevice();
+    audioOpened = false;
+    soundEnabled = false;
 }
 
+void QueueSound(SoundId id) {
+    if (!soundEnabled) return;
+    unsigned head = queueHead;
+    if (head - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE) == SOUND_QUEUE_SIZE) return;   // cheia: descarta
+    queue[head & (SOUND_QUEUE_SIZE - 1)] = (uint8_t)id;
+    __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+}
+
+void PlayQueuedSounds(void) {
+    if (!soundEnabled) return;
 
+    // Junta os pedidos do quadro: cada som toca no máximo uma vez
+    unsigned head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+    unsigned pending = 0;
+    for (unsigned i = queueTail; i != head; i++) pending |= 1u << queue[i & (SOUND_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queueTail, head, __ATOMIC_RELEASE);
+    if (!pending) return;
+    if (!audioOpened && !OpenAudio()) {
+        soundEnabled = false;   // sem dispositivo: daqui em diante tudo é no-op
+        return;
+    }
+
+    while (pending) {
+        int s = __builtin_ctz(pending);
+        pending &= pending - 1;
+        for (int v = 0; v < voiceCount[s]; v++) {
+            if (IsSoundPlaying(voices[s][v])) continue;
+            PlaySound(voices[s][v]);
+            break;
+        }
+    }
+}
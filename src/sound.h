@@ -1,13 +1,54 @@
 #ifndef SOUND_H
 #define SOUND_H
 
-extern Sound paddleHitSound;
-extern Sound brickHitSound;
-extern Sound gameOverSound;
-extern Sound restartSound;
+#include <stdbool.h>
 
-void LoadSounds(void);
+/*
+ * Efeitos sonoros por fila de eventos. Quem dá os passos da simulação só
+ * enfileira o id do som (QueueSound: um byte numa fila circular sem locks);
+ * uma vez por quadro PlayQueuedSounds esvazia a fila, junta os pedidos
+ * repetidos do mesmo som num só e toca cada um numa voz livre. Cada som tem
+ * SOUND_VOICES vozes (aliases do mesmo áudio): com todas tocando, o pedido
+ * do quadro é descartado.
+ *
+ * O áudio vem embutido no executável (assets.h) e o dispositivo só é aberto
+ * no primeiro PlayQueuedSounds com algum som pendente: modos que nunca tocam
+ * nada não pagam InitAudioDevice. Sem dispositivo tudo vira no-op.
+ */
 
+#define SOUND_QUEUE_SIZE 256    // eventos por quadro antes de descartar (potência de 2)
+#define SOUND_VOICES     4      // reproduções simultâneas de um mesmo som
+
+typedef enum {
+    SFX_PADDLE_HIT,
+    SFX_BRICK_HIT,
+    SFX_GAME_OVER,
+    SFX_RESTART,
+    SFX_COUNT
+} SoundId;
+
+/**
+ * Liga a fila de sons; o dispositivo e as vozes ficam para o primeiro som.
+ * @param enabled false para rodar sem som (nem abre o dispositivo).
+ */
+void LoadSounds(bool enabled);
+
+/**
+ * Descarrega as vozes e fecha o dispositivo, se ele chegou a ser aberto.
+ */
 void UnloadSounds(void);
 
-#endif // SOUND_H
\ No newline at end of file
+/**
+ * Enfileira um som para o próximo PlayQueuedSounds. Um só produtor.
+ * @param id Som.
+ */
+void QueueSound(SoundId id);
+
+/**
+ * Esvazia a fila: cada som pedido desde o último quadro toca uma vez, se
+ * houver voz livre. Abre o dispositivo no primeiro som. Chamar uma vez por
+ * quadro, na thread da janela.
+ */
+void PlayQueuedSounds(void);
+
+#endif // SOUND_H
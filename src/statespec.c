@@ -0,0 +1,33 @@
+#include "statespec.h"
+#include <string.h>
+
+// Um codificador especializado por preset
+STATE_ENCODER(EncodeDefault, STATE_SPEC_DEFAULT)
+STATE_ENCODER(EncodeCoarse, STATE_SPEC_COARSE)
+STATE_ENCODER(EncodeNearPaddle, STATE_SPEC_NEAR_PADDLE)
+
+const StateSpec STATE_SPECS[] = {
+    { "default", STATE_SPEC_DEFAULT_ID, STATE_COUNT(STATE_SPEC_DEFAULT), STATE_BINS(STATE_SPEC_DEFAULT), EncodeDefault },
+    { "coarse", STATE_SPEC_COARSE_ID, STATE_COUNT(STATE_SPEC_COARSE), STATE_BINS(STATE_SPEC_COARSE), EncodeCoarse },
+    { "near-paddle", STATE_SPEC_NEAR_PADDLE_ID, STATE_COUNT(STATE_SPEC_NEAR_PADDLE), STATE_BINS(STATE_SPEC_NEAR_PADDLE),
+      EncodeNearPaddle },
+};
+const int STATE_SPEC_COUNT = (int)(sizeof(STATE_SPECS) / sizeof(STATE_SPECS[0]));
+
+const StateSpec *state_spec_default(void) {
+    return state_spec_by_id(STATE_SPEC_ID);
+}
+
+const StateSpec *state_spec_find(const char *name) {
+    for (int i = 0; i < STATE_SPEC_COUNT; i++) {
+        if (strcmp(STATE_SPECS[i].name, name) == 0) return &STATE_SPECS[i];
+    }
+    return NULL;
+}
+
+const StateSpec *state_spec_by_id(uint32_t id) {
+    for (int i = 0; i < STATE_SPEC_COUNT; i++) {
+        if (STATE_SPECS[i].id == id) return &STATE_SPECS[i];
+    }
+    return NULL;
+}
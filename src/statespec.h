@@ -0,0 +1,165 @@
+#ifndef STATESPEC_H
+#define STATESPEC_H
+
+#include "defs.h"
+#include <stdint.h>
+
+/*
+ * Discretização do estado definida em tempo de compilação. Uma especificação
+ * é uma X-macro que lista as dimensões em ordem (a primeira é a mais
+ * significativa no índice), cada uma com um dos três tipos:
+ *
+ *   U(nome, expr, bins, min, max)         bins uniformes em [min, max]
+ *   S(nome, expr)                         sinal: negativo / ~zero / positivo
+ *   E(nome, expr, bins, min, max, lut)    bins não uniformes: a faixa é
+ *                                         dividida em STATE_LUT_CELLS células
+ *                                         e lut[célula] dá o bin
+ *
+ * STATE_ENCODER gera um codificador especializado para a especificação: a
+ * escala bins / (max - min) de cada dimensão é uma constante, então o passo
+ * só tem multiplicações (nenhuma divisão). STATE_COUNT dá o número de estados.
+ *
+ * Todos os presets são instanciados em statespec.c e descritos em STATE_SPECS
+ * (codificador + número de estados); a Q-table guarda o descritor com que foi
+ * criada, então a discretização é escolhida em tempo de execução
+ * (--state-spec, chave state_spec da varredura, ou a do arquivo carregado).
+ * ARKANOID_STATE_SPEC escolhe só o padrão, STATE_SPEC.
+ */
+
+// Células da tabela de bins não uniformes
+#define STATE_LUT_CELLS 64
+
+// Velocidade abaixo disso (em módulo) conta como parada em S(...)
+#define STATE_SIGN_DEADZONE 10.0f
+
+// Bola Y com bins mais finos perto do paddle (y = SCREEN_H - 40): 4 bins de
+// 75 px no topo, 4 de 37.5 px, 4 de 18.75 px e 8 de 9.4 px na faixa do paddle
+static const unsigned char STATE_LUT_BALL_Y_NEAR_PADDLE[STATE_LUT_CELLS] = {
+     0,  0,  0,  0,  0,  0,  0,  0,   1,  1,  1,  1,  1,  1,  1,  1,
+     2,  2,  2,  2,  2,  2,  2,  2,   3,  3,  3,  3,  3,  3,  3,  3,
+     4,  4,  4,  4,  5,  5,  5,  5,   6,  6,  6,  6,  7,  7,  7,  7,
+     8,  8,  9,  9, 10, 10, 11, 11,  12, 13, 14, 15, 16, 17, 18, 19,
+};
+
+// Padrão: 12 x 12 x 16 x 3 x 3 = 20736 estados
+#define STATE_SPEC_DEFAULT(U, S, E)                             \
+    U(PADDLE_X, paddle.x,   12, 0.0f, SCREEN_W - PADDLE_W)      \
+    U(BALL_X,   ball.pos.x, 12, 0.0f, SCREEN_W)                 \
+    U(BALL_Y,   ball.pos.y, 16, 0.0f, SCREEN_H)                 \
+    S(BALL_VX,  ball.vel.x)                                     \
+    S(BALL_VY,  ball.vel.y)
+#define STATE_SPEC_DEFAULT_ID 0
+
+// Grosseira: 6 x 6 x 8 x 3 x 3 = 2592 estados (aprende rápido, teto baixo)
+#define STATE_SPEC_COARSE(U, S, E)                              \
+    U(PADDLE_X, paddle.x,   6, 0.0f, SCREEN_W - PADDLE_W)       \
+    U(BALL_X,   ball.pos.x, 6, 0.0f, SCREEN_W)                  \
+    U(BALL_Y,   ball.pos.y, 8, 0.0f, SCREEN_H)                  \
+    S(BALL_VX,  ball.vel.x)                                     \
+    S(BALL_VY,  ball.vel.y)
+#define STATE_SPEC_COARSE_ID 1
+
+// Resolução concentrada perto do paddle: 12 x 12 x 20 x 3 x 3 = 25920 estados
+#define STATE_SPEC_NEAR_PADDLE(U, S, E)                         \
+    U(PADDLE_X, paddle.x,   12, 0.0f, SCREEN_W - PADDLE_W)      \
+    U(BALL_X,   ball.pos.x, 12, 0.0f, SCREEN_W)                 \
+    E(BALL_Y,   ball.pos.y, 20, 0.0f, SCREEN_H, STATE_LUT_BALL_Y_NEAR_PADDLE) \
+    S(BALL_VX,  ball.vel.x)                                     \
+    S(BALL_VY,  ball.vel.y)
+#define STATE_SPEC_NEAR_PADDLE_ID 2
+
+// Especificação padrão quando nenhuma é escolhida (-DARKANOID_STATE_SPEC=COARSE, etc.)
+#ifndef ARKANOID_STATE_SPEC
+#define ARKANOID_STATE_SPEC DEFAULT
+#endif
+#define STATE_CAT_(a, b) a##b
+#define STATE_CAT(a, b) STATE_CAT_(a, b)
+#define STATE_SPEC STATE_CAT(STATE_SPEC_, ARKANOID_STATE_SPEC)
+#define STATE_SPEC_ID STATE_CAT(STATE_CAT(STATE_SPEC_, ARKANOID_STATE_SPEC), _ID)
+
+/* ---------- Geração ---------- */
+
+// Bin de um eixo uniforme a partir da escala pré-calculada bins / (max - min)
+static inline int state_bin(float value, float min, float scale, int bins) {
+    int idx = (int)((value - min) * scale);
+    if (idx < 0) idx = 0;
+    if (idx >= bins) idx = bins - 1;
+    return idx;
+}
+
+static inline int state_sign_bin(float v) {
+    return (v > STATE_SIGN_DEADZONE) + (v >= -STATE_SIGN_DEADZONE);
+}
+
+#define STATE_COUNT_U(name, expr, bins, min, max) * (bins)
+#define STATE_COUNT_S(name, expr) * 3
+#define STATE_COUNT_E(name, expr, bins, min, max, lut) * (bins)
+
+// Número de estados de uma especificação (expressão constante)
+#define STATE_COUNT(SPEC) (1 SPEC(STATE_COUNT_U, STATE_COUNT_S, STATE_COUNT_E))
+
+#define STATE_ENC_U(name, expr, bins, min, max) \
+    idx = idx * (bins) + state_bin(expr, min, (float)(bins) / (float)((max) - (min)), bins);
+#define STATE_ENC_S(name, expr) \
+    idx = idx * 3 + state_sign_bin(expr);
+#define STATE_ENC_E(name, expr, bins, min, max, lut) \
+    idx = idx * (bins) + (lut)[state_bin(expr, min, (float)STATE_LUT_CELLS / (float)((max) - (min)), STATE_LUT_CELLS)];
+
+// Define `static inline int fn(Rectangle paddle, Ball ball)` para a especificação
+#define STATE_ENCODER(fn, SPEC)                                 \
+    static inline int fn(Rectangle paddle, Ball ball) {         \
+        int idx = 0;                                            \
+        SPEC(STATE_ENC_U, STATE_ENC_S, STATE_ENC_E)             \
+        (void)paddle;                                           \
+        (void)ball;                                             \
+        return idx;                                             \
+    }
+
+#define STATE_BINS_U(name, expr, bins, min, max) (bins),
+#define STATE_BINS_S(name, expr) 3,
+#define STATE_BINS_E(name, expr, bins, min, max, lut) (bins),
+
+// Bins de cada dimensão, em ordem (inicializador de vetor)
+#define STATE_BINS(SPEC) { SPEC(STATE_BINS_U, STATE_BINS_S, STATE_BINS_E) }
+
+/* ---------- Escolha em tempo de execução ---------- */
+
+#define STATE_MAX_DIMS 5            // dimensões gravadas nos cabeçalhos dos arquivos
+
+// Codificador de uma especificação (gerado por STATE_ENCODER)
+typedef int (*StateEncoder)(Rectangle paddle, Ball ball);
+
+// Descritor de uma especificação instanciada
+typedef struct {
+    const char *name;               // nome em --state-spec e na varredura
+    uint32_t id;                    // STATE_SPEC_*_ID, gravado nos arquivos
+    int nStates;                    // STATE_COUNT da especificação
+    uint32_t bins[STATE_MAX_DIMS];  // bins de cada dimensão (0 nas que faltam)
+    StateEncoder encode;
+} StateSpec;
+
+// Presets instanciados, na ordem dos ids
+extern const StateSpec STATE_SPECS[];
+extern const int STATE_SPEC_COUNT;
+
+/**
+ * Especificação padrão desta compilação (STATE_SPEC).
+ * @return Descritor.
+ */
+const StateSpec *state_spec_default(void);
+
+/**
+ * Procura uma especificação pelo nome.
+ * @param name Nome ("default", "coarse" ou "near-paddle").
+ * @return Descritor, ou NULL se o nome não existe.
+ */
+const StateSpec *state_spec_find(const char *name);
+
+/**
+ * Procura uma especificação pelo id gravado em arquivo.
+ * @param id STATE_SPEC_*_ID.
+ * @return Descritor, ou NULL se o id não existe.
+ */
+const StateSpec *state_spec_by_id(uint32_t id);
+
+#endif // STATESPEC_H
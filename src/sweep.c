@@ -0,0 +1,409 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sweep.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *const dimNames[SWEEP_DIMS] = {
+    "alpha", "gamma", "epsilon", "epsilon_decay", "min_epsilon", "lambda", "learner", "state_spec", "seed", "episodes",
+    "max_steps"
+};
+
+// Dimensões inteiras não aceitam faixa
+static bool DimIsInteger(int dim) {
+    return dim == SWEEP_LEARNER || dim == SWEEP_STATE_SPEC || dim == SWEEP_SEED || dim == SWEEP_EPISODES
+        || dim == SWEEP_MAX_STEPS;
+}
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ---------- Especificação ---------- */
+
+static char *Trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+static bool ParseNumber(const char *text, double *out) {
+    char *end;
+    *out = strtod(text, &end);
+    return end != text && *Trim(end) == '\0';
+}
+
+// Converte um valor da dimensão; learner e state_spec aceitam os nomes de
+// --learner e --state-spec (state_spec vira a posição em STATE_SPECS)
+static bool ParseValue(int dim, char *text, double *out) {
+    text = Trim(text);
+    if (dim == SWEEP_LEARNER) {
+        int learner = train_learner_parse(text);
+        *out = learner;
+        return learner >= 0;
+    }
+    if (dim == SWEEP_STATE_SPEC) {
+        const StateSpec *spec = state_spec_find(text);
+        *out = spec ? (double)(spec - STATE_SPECS) : -1.0;
+        return spec != NULL;
+    }
+    if (!ParseNumber(text, out)) return false;
+    return dim != SWEEP_EPISODES || *out >= 1.0;
+}
+
+static bool ParseLine(SweepSpec *spec, char *line, char *err, size_t errSize) {
+    char *eq = strchr(line, '=');
+    if (!eq) {
+        snprintf(err, errSize, "esperado 'chave = valores'");
+        return false;
+    }
+    *eq = '\0';
+    char *key = Trim(line);
+    char *value = Trim(eq + 1);
+
+    if (strcmp(key, "samples") == 0) {
+        double n;
+        if (!ParseNumber(value, &n) || n < 1.0 || n > SWEEP_MAX_CONFIGS) {
+            snprintf(err, errSize, "samples inválido: %s", value);
+            return false;
+        }
+        spec->samples = (int)n;
+        return true;
+    }
+
+    int dim = -1;
+    for (int d = 0; d < SWEEP_DIMS; d++) {
+        if (strcmp(key, dimNames[d]) == 0) dim = d;
+    }
+    if (dim < 0) {
+        snprintf(err, errSize, "chave desconhecida: %s", key);
+        return false;
+    }
+    SweepDim *sd = &spec->dims[dim];
+    if (sd->count > 0) {
+        snprintf(err, errSize, "chave repetida: %s", key);
+        return false;
+    }
+
+    // Faixa "min .. max": sorteada na busca aleatória
+    char *dots = strstr(value, "..");
+    if (dots) {
+        *dots = '\0';
+        if (DimIsInteger(dim)) {
+            snprintf(err, errSize, "%s não aceita faixa", key);
+            return false;
+        }
+        if (!ParseValue(dim, value, &sd->values[0]) || !ParseValue(dim, dots + 2, &sd->values[1])
+            || sd->values[0] > sd->values[1]) {
+            snprintf(err, errSize, "faixa inválida para %s", key);
+            return false;
+        }
+        sd->count = 2;
+        sd->range = true;
+        return true;
+    }
+
+    for (char *tok = strtok(value, ","); tok; tok = strtok(NULL, ",")) {
+        if (sd->count == SWEEP_MAX_VALUES) {
+            snprintf(err, errSize, "mais de %d valores para %s", SWEEP_MAX_VALUES, key);
+            return false;
+        }
+        if (!ParseValue(dim, tok, &sd->values[sd->count])) {
+            snprintf(err, errSize, "valor inválido para %s: %s", key, Trim(tok));
+            return false;
+        }
+        sd->count++;
+    }
+    if (sd->count == 0) {
+        snprintf(err, errSize, "%s sem valores", key);
+        return false;
+    }
+    return true;
+}
+
+bool sweep_load_spec(SweepSpec *spec, const char *path, char *err, size_t errSize) {
+    memset(spec, 0, sizeof(*spec));
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        snprintf(err, errSize, "não foi possível abrir %s", path);
+        return false;
+    }
+    char line[1024];
+    char reason[256];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNo++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *text = Trim(line);
+        if (*text == '\0') continue;
+        if (!ParseLine(spec, text, reason, sizeof(reason))) {
+            snprintf(err, errSize, "%s:%d: %s", path, lineNo, reason);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+/* ---------- Expansão ---------- */
+
+static void SetDim(SweepConfig *c, int dim, double v) {
+    switch (dim) {
+        case SWEEP_ALPHA:         c->params.alpha = (float)v; break;
+        case SWEEP_GAMMA:         c->params.gamma = (float)v; break;
+        case SWEEP_EPSILON:       c->params.epsilon = (float)v; break;
+        case SWEEP_EPSILON_DECAY: c->params.epsilonDecay = (float)v; break;
+        case SWEEP_MIN_EPSILON:   c->params.minEpsilon = (float)v; break;
+        case SWEEP_LAMBDA:        c->params.lambda = (float)v; break;
+        case SWEEP_LEARNER:       c->params.learner = (int)v; break;
+        case SWEEP_STATE_SPEC:    c->spec = &STATE_SPECS[(int)v]; break;
+        case SWEEP_SEED:          c->seed = (uint64_t)v; break;
+        case SWEEP_EPISODES:      c->episodes = (long)v; break;
+        case SWEEP_MAX_STEPS:     c->maxSteps = (long)v; break;
+    }
+}
+
+SweepConfig *sweep_expand(const SweepSpec *spec, uint64_t seed, int *count) {
+    SweepConfig base;
+    TrainParams defaults = TRAIN_PARAMS_DEFAULT;
+    base.params = defaults;
+    base.spec = state_spec_default();
+    base.seed = seed;
+    base.episodes = 1000;
+    base.maxSteps = 20000;
+
+    bool random = false;
+    long total = 1;
+    for (int d = 0; d < SWEEP_DIMS; d++) {
+        const SweepDim *sd = &spec->dims[d];
+        if (sd->range) random = true;
+        else if (sd->count > 0) total *= sd->count;
+        if (total > SWEEP_MAX_CONFIGS) return NULL;
+    }
+    if (random) total = spec->samples > 0 ? spec->samples : SWEEP_DEFAULT_SAMPLES;
+
+    SweepConfig *configs = (SweepConfig *)malloc((size_t)total * sizeof(SweepConfig));
+    if (!configs) return NULL;
+
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (long i = 0; i < total; i++) {
+        SweepConfig *c = &configs[i];
+        *c = base;
+        long rest = i;
+        // Na grade, a última chave varia mais rápido
+        for (int d = SWEEP_DIMS - 1; d >= 0; d--) {
+            const SweepDim *sd = &spec->dims[d];
+            if (sd->count == 0) continue;
+            double v;
+            if (sd->range) {
+                v = sd->values[0] + (sd->values[1] - sd->values[0]) * rng_float(&rng);
+            } else if (random) {
+                v = sd->values[rng_range(&rng, 0, sd->count - 1)];
+            } else {
+                v = sd->values[rest % sd->count];
+                rest /= sd->count;
+            }
+            SetDim(c, d, v);
+        }
+    }
+    *count = (int)total;
+    return configs;
+}
+
+/* ---------- Treino ---------- */
+
+// Um treino completo, como o modo de um jogo do headless
+static void RunConfig(const SweepConfig *c, float dt, int collision, const Level *level, SweepResult *r) {
+    memset(r, 0, sizeof(*r));
+    int windows = (int)((c->episodes + SWEEP_WINDOW - 1) / SWEEP_WINDOW);
+    r->curve = (float *)malloc((size_t)windows * sizeof(float));
+    double *times = (double *)malloc((size_t)windows * sizeof(double));
+
+    bool linear = c->params.learner == LEARNER_LINEAR;
+    QTable *Q = NULL;
+    LinearQ *L = NULL;
+    TraceAgent traceAgent;
+    TraceAgent *traces = NULL;
+    bool ready = r->curve && times;
+    if (ready && linear) {
+        ready = posix_memalign((void **)&L, 32, sizeof(LinearQ)) == 0;
+        if (ready) linear_init(L);
+    } else if (ready) {
+        Q = init_q_table(c->spec);
+        ready = Q != NULL;
+        if (ready && c->params.learner != LEARNER_Q) {
+            ready = train_trace_agent_init(&traceAgent);
+            traces = &traceAgent;
+        }
+    }
+
+    if (ready) {
+        SimState sim;
+        sim_init(&sim, dt, rng_env_seed(c->seed, 0));
+        sim.collision = collision;
+        sim_set_level(&sim, level);
+        Rng rng;
+        rng_seed(&rng, rng_agent_seed(c->seed, 0));
+
+        float epsilon = c->params.epsilon;
+        long windowScore = 0;
+        double start = NowSeconds();
+        for (long episode = 1; episode <= c->episodes; episode++) {
+            TrainEpisodeStats es;
+            windowScore += linear
+                         ? train_episode_linear(L, &sim, &c->params, epsilon, c->maxSteps, &es, &rng)
+                         : train_episode(Q, &sim, &c->params, epsilon, c->maxSteps, &es, &rng, NULL, traces);
+            r->steps += es.steps;
+            epsilon = train_decay_epsilon(&c->params, epsilon);
+
+            // Fecha a janela (a última pode ser parcial)
+            long inWindow = (episode - 1) % SWEEP_WINDOW + 1;
+            if (inWindow == SWEEP_WINDOW || episode == c->episodes) {
+                r->curve[r->windows] = (float)windowScore / inWindow;
+                times[r->windows] = NowSeconds() - start;
+                r->windows++;
+                windowScore = 0;
+            }
+        }
+        r->seconds = NowSeconds() - start;
+
+        r->bestMean = r->curve[0];
+        for (int w = 1; w < r->windows; w++) {
+            if (r->curve[w] > r->bestMean) r->bestMean = r->curve[w];
+        }
+        r->finalMean = r->curve[r->windows - 1];
+        for (int w = 0; w < r->windows; w++) {
+            if (r->curve[w] >= SWEEP_CONVERGE_FRACTION * r->bestMean) {
+                r->convergedEpisode = w + 1 < r->windows ? (long)(w + 1) * SWEEP_WINDOW : c->episodes;
+                r->convergedSeconds = times[w];
+                break;
+            }
+        }
+        r->ok = true;
+    }
+
+    if (traces) train_trace_agent_free(traces);
+    if (Q) free_q_table(Q);
+    free(L);
+    free(times);
+    if (!r->ok) {
+        free(r->curve);
+        r->curve = NULL;
+    }
+}
+
+// Estado compartilhado do pool
+typedef struct {
+    const SweepConfig *configs;
+    SweepResult *results;
+    int count;
+    float dt;
+    int collision;
+    const Level *level;     // imagem compartilhada por todas as threads
+    int next;               // próxima configuração a reservar
+    int done;               // configurações concluídas
+    pthread_mutex_t printLock;
+} SweepPool;
+
+static void PrintResult(SweepPool *pool, int i, int done) {
+    const SweepConfig *c = &pool->configs[i];
+    const SweepResult *r = &pool->results[i];
+    pthread_mutex_lock(&pool->printLock);
+    if (!r->ok) {
+        printf("[%d/%d] #%d: falha ao alocar o treino\n", done, pool->count, i);
+    } else {
+        printf("[%d/%d] #%d %s %s alpha=%.4g gamma=%.4g eps=%.4g decay=%.5g min=%.4g lambda=%.3g seed=%llu: "
+               "final %.2f, melhor %.2f, convergiu no ep. %ld (%.1f s), %.1f s\n",
+               done, pool->count, i, train_learner_name(c->params.learner), c->spec->name, c->params.alpha, c->params.gamma,
+               c->params.epsilon, c->params.epsilonDecay, c->params.minEpsilon, c->params.lambda,
+               (unsigned long long)c->seed, r->finalMean, r->bestMean, r->convergedEpisode, r->convergedSeconds,
+               r->seconds);
+    }
+    fflush(stdout);
+    pthread_mutex_unlock(&pool->printLock);
+}
+
+static void *PoolMain(void *arg) {
+    SweepPool *pool = (SweepPool *)arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        if (i >= pool->count) break;
+        RunConfig(&pool->configs[i], pool->dt, pool->collision, pool->level, &pool->results[i]);
+        PrintResult(pool, i, __atomic_add_fetch(&pool->done, 1, __ATOMIC_RELAXED));
+    }
+    return NULL;
+}
+
+bool sweep_run(const SweepConfig *configs, int count, int threads, float dt, int collision, const Level *level,
+               SweepResult *results) {
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > count) threads = count > 0 ? count : 1;
+
+    SweepPool pool = { configs, results, count, dt, collision, level, 0, 0, PTHREAD_MUTEX_INITIALIZER };
+    pthread_t *handles = (pthread_t *)malloc((size_t)threads * sizeof(pthread_t));
+    if (!handles) return false;
+
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, PoolMain, &pool) != 0) break;
+        started++;
+    }
+    // Com menos threads o pool só demora mais; sem nenhuma, treina aqui mesmo
+    if (started == 0) PoolMain(&pool);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    free(handles);
+    pthread_mutex_destroy(&pool.printLock);
+    return true;
+}
+
+/* ---------- Resultados ---------- */
+
+bool sweep_write_csv(const char *path, const SweepConfig *configs, const SweepResult *results, int count) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "id");
+    for (int d = 0; d < SWEEP_DIMS; d++) fprintf(file, ",%s", dimNames[d]);
+    fprintf(file, ",final_mean,best_mean,converged_episode,converged_seconds,steps,seconds,steps_per_second,curve\n");
+
+    for (int i = 0; i < count; i++) {
+        const SweepConfig *c = &configs[i];
+        const SweepResult *r = &results[i];
+        fprintf(file, "%d,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%s,%s,%llu,%ld,%ld", i, c->params.alpha, c->params.gamma,
+                c->params.epsilon, c->params.epsilonDecay, c->params.minEpsilon, c->params.lambda,
+                train_learner_name(c->params.learner), c->spec->name, (unsigned long long)c->seed, c->episodes,
+                c->maxSteps);
+        if (!r->ok) {
+            fprintf(file, ",,,,,,,,\n");
+            continue;
+        }
+        fprintf(file, ",%.2f,%.2f,%ld,%.3f,%ld,%.3f,%.0f,", r->finalMean, r->bestMean, r->convergedEpisode,
+                r->convergedSeconds, r->steps, r->seconds, r->seconds > 0.0 ? r->steps / r->seconds : 0.0);
+        for (int w = 0; w < r->windows; w++) fprintf(file, w ? ";%.2f" : "%.2f", r->curve[w]);
+        fputc('\n', file);
+    }
+    return fclose(file) == 0;
+}
+
+void sweep_free_results(SweepResult *results, int count) {
+    for (int i = 0; i < count; i++) {
+        free(results[i].curve);
+        results[i].curve = NULL;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "train.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Varredura de hiperparâmetros: cada configuração é um treino completo e
+ * independente (Q-table, simulação e geradores próprios) e um pool de
+ * threads executa várias ao mesmo tempo. Como nada é compartilhado, o
+ * resultado de cada configuração não depende do número de threads.
+ *
+ * O arquivo de especificação tem uma chave por linha ('#' comenta):
+ *
+ *   alpha = 0.05, 0.1, 0.2      lista: todos os valores (grade)
+ *   gamma = 0.9 .. 0.99         faixa: sorteio uniforme (busca aleatória)
+ *   samples = 32                configurações da busca aleatória
+ *
+ * Chaves: alpha, gamma, epsilon, epsilon_decay, min_epsilon, lambda,
+ * learner (nomes de --learner), state_spec (nomes de --state-spec), seed,
+ * episodes e max_steps. As ausentes
+ * usam os valores padrão do treino. Sem nenhuma faixa, a varredura é o
+ * produto cartesiano das listas; com alguma faixa, são `samples` sorteios
+ * (listas contribuem com um de seus valores, sorteado).
+ */
+
+#define SWEEP_MAX_VALUES 32             // valores por chave
+#define SWEEP_MAX_CONFIGS 100000        // limite do produto da grade
+#define SWEEP_DEFAULT_SAMPLES 16        // busca aleatória sem `samples`
+#define SWEEP_WINDOW 100                // episódios por ponto da curva
+#define SWEEP_CONVERGE_FRACTION 0.9f    // convergiu: janela >= 90% da melhor
+
+// Dimensões da varredura (ordem das colunas do CSV)
+enum {
+    SWEEP_ALPHA,
+    SWEEP_GAMMA,
+    SWEEP_EPSILON,
+    SWEEP_EPSILON_DECAY,
+    SWEEP_MIN_EPSILON,
+    SWEEP_LAMBDA,
+    SWEEP_LEARNER,
+    SWEEP_STATE_SPEC,
+    SWEEP_SEED,
+    SWEEP_EPISODES,
+    SWEEP_MAX_STEPS,
+    SWEEP_DIMS
+};
+
+// Valores de uma dimensão: lista (count > 0) ou faixa [values[0], values[1]]
+typedef struct {
+    int count;
+    bool range;
+    double values[SWEEP_MAX_VALUES];
+} SweepDim;
+
+typedef struct {
+    SweepDim dims[SWEEP_DIMS];
+    int samples;            // configurações da busca aleatória
+} SweepSpec;
+
+// Uma configuração a treinar
+typedef struct {
+    TrainParams params;
+    const StateSpec *spec;  // discretização da Q-table
+    uint64_t seed;
+    long episodes;
+    long maxSteps;
+} SweepConfig;
+
+// Resultado de uma configuração
+typedef struct {
+    float *curve;           // score médio de cada janela de SWEEP_WINDOW episódios
+    int windows;            // pontos em curve
+    float finalMean;        // última janela
+    float bestMean;         // melhor janela
+    long convergedEpisode;  // fim da primeira janela com >= SWEEP_CONVERGE_FRACTION da melhor
+    double convergedSeconds;// tempo de treino até convergedEpisode
+    long steps;             // passos simulados
+    double seconds;         // tempo de parede do treino
+    bool ok;                // false se faltou memória
+} SweepResult;
+
+/**
+ * Lê um arquivo de especificação.
+ * @param spec Saída.
+ * @param path Caminho.
+ * @param err Mensagem de erro (linha e motivo) quando falha.
+ * @param errSize Tamanho de err.
+ * @return true se o arquivo é válido.
+ */
+bool sweep_load_spec(SweepSpec *spec, const char *path, char *err, size_t errSize);
+
+/**
+ * Expande a especificação em configurações (grade ou sorteios).
+ * @param spec Especificação.
+ * @param seed Semente dos sorteios da busca aleatória e dos treinos quando a
+ *             especificação não lista `seed`.
+ * @param count Saída com o número de configurações.
+ * @return Vetor alocado com malloc (liberar com free), ou NULL se falhou.
+ */
+SweepConfig *sweep_expand(const SweepSpec *spec, uint64_t seed, int *count);
+
+/**
+ * Treina todas as configurações num pool de threads e bloqueia até o fim,
+ * imprimindo uma linha por configuração concluída.
+ * @param configs Configurações.
+ * @param count Número de configurações.
+ * @param threads Tamanho do pool (<= 0 usa os núcleos disponíveis).
+ * @param dt Passo fixo da simulação.
+ * @param collision Modo de colisão (SIM_COLLISION_*).
+ * @param level Nível jogado por todas as configurações (NULL = embutido).
+ * @param results Saída com count posições (liberar com sweep_free_results).
+ * @return true se o pool foi criado.
+ */
+bool sweep_run(const SweepConfig *configs, int count, int threads, float dt, int collision, const Level *level,
+               SweepResult *results);
+
+/**
+ * Grava a tabela de resultados em CSV: uma linha por configuração com os
+ * hiperparâmetros, as métricas e a curva (médias separadas por ';').
+ * @param path Caminho.
+ * @param configs Configurações.
+ * @param results Resultados.
+ * @param count Número de configurações.
+ * @return true se gravou.
+ */
+bool sweep_write_csv(const char *path, const SweepConfig *configs, const SweepResult *results, int count);
+
+/**
+ * Libera as curvas dos resultados.
+ * @param results Resultados.
+ * @param count Número de configurações.
+ */
+void sweep_free_results(SweepResult *results, int count);
+
+#endif // SWEEP_H
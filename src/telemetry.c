@@ -0,0 +1,208 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "telemetry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Escrita de quem é dono do slot: leitura comum, gravação atômica relaxada
+#define SLOT_ADD(field, v) __atomic_store_n(&(field), (field) + (v), __ATOMIC_RELAXED)
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Balde de potência de 2: 0 para v < 1, k para v em [2^(k-1), 2^k)
+static int Bucket(double v) {
+    if (v < 1.0) return 0;
+    unsigned long n = v >= (double)(1ul << (TELEMETRY_BUCKETS - 2)) ? (1ul << (TELEMETRY_BUCKETS - 2)) : (unsigned long)v;
+    return (int)(sizeof(unsigned long) * 8) - __builtin_clzl(n);
+}
+
+static void SlotAddDouble(double *field, double v) {
+    double sum = *field + v;
+    __atomic_store(field, &sum, __ATOMIC_RELAXED);
+}
+
+void telemetry_episode(TelemetrySlot *slot, const TrainEpisodeStats *stats, int score, float epsilon) {
+    if (!slot) return;
+    TelemetryCounters *c = &slot->c;
+    SLOT_ADD(c->scoreSum, score);
+    SLOT_ADD(c->scoreHist[Bucket(score)], 1);
+    __atomic_store(&c->epsilon, &epsilon, __ATOMIC_RELAXED);
+    if (stats) {
+        SLOT_ADD(c->steps, stats->steps);
+        SLOT_ADD(c->paddleHits, stats->paddleHits);
+        SLOT_ADD(c->brickHits, stats->brickHits);
+        SlotAddDouble(&c->rewardSum, stats->rewardSum);
+        SlotAddDouble(&c->qAbsSum, stats->qAbsSum);
+        SLOT_ADD(c->lengthHist[Bucket(stats->steps)], 1);
+        SLOT_ADD(c->qAbsHist[Bucket(stats->steps > 0 ? stats->qAbsSum / stats->steps : 0.0)], 1);
+    }
+    // Por último: quem lê um episódio novo já vê as somas dele
+    __atomic_store_n(&c->episodes, c->episodes + 1, __ATOMIC_RELEASE);
+}
+
+/* ---------- Gravação ---------- */
+
+static void SumSlots(const Telemetry *t, TelemetryCounters *sum) {
+    memset(sum, 0, sizeof(*sum));
+    int active = 0;
+    float epsilonSum = 0.0f;
+    for (int i = 0; i < t->count; i++) {
+        const TelemetryCounters *c = &t->slots[i].c;
+        long episodes = __atomic_load_n(&c->episodes, __ATOMIC_ACQUIRE);
+        sum->episodes += episodes;
+        sum->steps += __atomic_load_n(&c->steps, __ATOMIC_RELAXED);
+        sum->scoreSum += __atomic_load_n(&c->scoreSum, __ATOMIC_RELAXED);
+        sum->paddleHits += __atomic_load_n(&c->paddleHits, __ATOMIC_RELAXED);
+        sum->brickHits += __atomic_load_n(&c->brickHits, __ATOMIC_RELAXED);
+        double d;
+        __atomic_load(&c->rewardSum, &d, __ATOMIC_RELAXED);
+        sum->rewardSum += d;
+        __atomic_load(&c->qAbsSum, &d, __ATOMIC_RELAXED);
+        sum->qAbsSum += d;
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+            sum->lengthHist[b] += __atomic_load_n(&c->lengthHist[b], __ATOMIC_RELAXED);
+            sum->scoreHist[b] += __atomic_load_n(&c->scoreHist[b], __ATOMIC_RELAXED);
+            sum->qAbsHist[b] += __atomic_load_n(&c->qAbsHist[b], __ATOMIC_RELAXED);
+        }
+        if (episodes > 0) {
+            float e;
+            __atomic_load(&c->epsilon, &e, __ATOMIC_RELAXED);
+            epsilonSum += e;
+            active++;
+        }
+    }
+    sum->epsilon = active > 0 ? epsilonSum / active : 0.0f;
+}
+
+static void WriteHist(FILE *f, const long *now, const long *last, bool csv) {
+    for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+        fprintf(f, b ? (csv ? ";%ld" : ",%ld") : "%ld", now[b] - last[b]);
+    }
+}
+
+// Grava a diferença entre a soma atual dos slots e a do registro anterior
+static void WriteRecord(Telemetry *t) {
+    TelemetryCounters now;
+    SumSlots(t, &now);
+    const TelemetryCounters *last = &t->last;
+    double time = NowSeconds();
+    double dt = time - t->lastTime;
+
+    long episodes = now.episodes - last->episodes;
+    long steps = now.steps - last->steps;
+    double perEpisode = episodes > 0 ? 1.0 / episodes : 0.0;
+    double scoreMean = (now.scoreSum - last->scoreSum) * perEpisode;
+    double lengthMean = steps * perEpisode;
+    double rewardMean = (now.rewardSum - last->rewardSum) * perEpisode;
+    double qAbsMean = steps > 0 ? (now.qAbsSum - last->qAbsSum) / steps : 0.0;
+    double episodesPerSecond = dt > 0.0 ? episodes / dt : 0.0;
+    double stepsPerSecond = dt > 0.0 ? steps / dt : 0.0;
+    FILE *f = t->file;
+
+    if (t->csv) {
+        fprintf(f, "%.3f,%ld,%ld,%ld,%.1f,%.0f,%.3f,%.1f,%.3f,%.4f,%ld,%ld,%.4f,", time - t->start, now.episodes, episodes,
+                steps, episodesPerSecond, stepsPerSecond, scoreMean, lengthMean, rewardMean, qAbsMean,
+                now.paddleHits - last->paddleHits, now.brickHits - last->brickHits, now.epsilon);
+        WriteHist(f, now.lengthHist, last->lengthHist, true);
+        fputc(',', f);
+        WriteHist(f, now.scoreHist, last->scoreHist, true);
+        fputc(',', f);
+        WriteHist(f, now.qAbsHist, last->qAbsHist, true);
+        fputc('\n', f);
+    } else {
+        fprintf(f, "{\"t\":%.3f,\"episodes_total\":%ld,\"episodes\":%ld,\"steps\":%ld,\"episodes_per_s\":%.1f,"
+                   "\"steps_per_s\":%.0f,\"score_mean\":%.3f,\"length_mean\":%.1f,\"reward_mean\":%.3f,"
+                   "\"q_abs_mean\":%.4f,\"paddle_hits\":%ld,\"brick_hits\":%ld,\"epsilon\":%.4f,\"length_hist\":[",
+                time - t->start, now.episodes, episodes, steps, episodesPerSecond, stepsPerSecond, scoreMean,
+                lengthMean, rewardMean, qAbsMean, now.paddleHits - last->paddleHits, now.brickHits - last->brickHits,
+                now.epsilon);
+        WriteHist(f, now.lengthHist, last->lengthHist, false);
+        fprintf(f, "],\"score_hist\":[");
+        WriteHist(f, now.scoreHist, last->scoreHist, false);
+        fprintf(f, "],\"q_abs_hist\":[");
+        WriteHist(f, now.qAbsHist, last->qAbsHist, false);
+        fprintf(f, "]}\n");
+    }
+    fflush(f);
+
+    t->last = now;
+    t->lastTime = time;
+    t->records++;
+}
+
+static void *FlusherMain(void *arg) {
+    Telemetry *t = (Telemetry *)arg;
+
+    pthread_mutex_lock(&t->lock);
+    while (!t->quit) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        double s = until.tv_nsec * 1e-9 + t->interval;
+        until.tv_sec += (time_t)s;
+        until.tv_nsec = (long)((s - (time_t)s) * 1e9);
+        while (!t->quit && pthread_cond_timedwait(&t->cond, &t->lock, &until) == 0) {}
+        if (t->quit) break;
+
+        pthread_mutex_unlock(&t->lock);
+        WriteRecord(t);
+        pthread_mutex_lock(&t->lock);
+    }
+    pthread_mutex_unlock(&t->lock);
+    return NULL;
+}
+
+bool telemetry_start(Telemetry *t, const char *path, int slots, double interval) {
+    memset(t, 0, sizeof(*t));
+    if (slots < 1) slots = 1;
+    t->count = slots;
+    t->interval = interval > 0.0 ? interval : TELEMETRY_DEFAULT_INTERVAL;
+    size_t len = strlen(path);
+    t->csv = len >= 4 && strcmp(path + len - 4, ".csv") == 0;
+
+    if (posix_memalign((void **)&t->slots, 64, (size_t)slots * sizeof(TelemetrySlot)) != 0) return false;
+    memset(t->slots, 0, (size_t)slots * sizeof(TelemetrySlot));
+    t->file = fopen(path, "w");
+    if (!t->file) {
+        free(t->slots);
+        return false;
+    }
+    if (t->csv) {
+        fprintf(t->file, "t,episodes_total,episodes,steps,episodes_per_s,steps_per_s,score_mean,length_mean,"
+                         "reward_mean,q_abs_mean,paddle_hits,brick_hits,epsilon,length_hist,score_hist,q_abs_hist\n");
+    }
+
+    t->start = t->lastTime = NowSeconds();
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->cond, NULL);
+    if (pthread_create(&t->thread, NULL, FlusherMain, t) != 0) {
+        pthread_mutex_destroy(&t->lock);
+        pthread_cond_destroy(&t->cond);
+        fclose(t->file);
+        free(t->slots);
+        return false;
+    }
+    return true;
+}
+
+void telemetry_stop(Telemetry *t) {
+    pthread_mutex_lock(&t->lock);
+    t->quit = true;
+    pthread_cond_broadcast(&t->cond);
+    pthread_mutex_unlock(&t->lock);
+    pthread_join(t->thread, NULL);
+
+    // Registro final com o que sobrou desde o último intervalo
+    WriteRecord(t);
+
+    pthread_mutex_destroy(&t->lock);
+    pthread_cond_destroy(&t->cond);
+    fclose(t->file);
+    free(t->slots);
+    t->file = NULL;
+    t->slots = NULL;
+}
@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "train.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * Telemetria do treino. Cada thread de treino escreve só no seu slot
+ * (contadores e histogramas, alinhado a uma linha de cache) e só no fim de
+ * cada episódio; o passo apenas soma em variáveis locais do episódio. Uma
+ * thread de fundo soma os slots a cada intervalo e grava um registro com as
+ * diferenças desde o anterior: JSONL, ou CSV quando o arquivo termina em .csv.
+ * O treino nunca espera pela escrita nem por locks.
+ */
+
+#define TELEMETRY_BUCKETS 16            // histogramas em potências de 2
+#define TELEMETRY_DEFAULT_INTERVAL 1.0  // segundos entre registros
+
+// Contadores de um slot (somas desde o início do treino)
+typedef struct {
+    long episodes;
+    long steps;
+    long scoreSum;
+    long paddleHits;
+    long brickHits;
+    double rewardSum;
+    double qAbsSum;             // soma de |Q(s,a)| por passo
+    float epsilon;              // último epsilon usado
+    long lengthHist[TELEMETRY_BUCKETS];     // passos por episódio
+    long scoreHist[TELEMETRY_BUCKETS];      // pontuação do episódio
+    long qAbsHist[TELEMETRY_BUCKETS];       // |Q| médio do episódio
+} TelemetryCounters;
+
+typedef struct {
+    TelemetryCounters c;
+} __attribute__((aligned(64))) TelemetrySlot;
+
+typedef struct {
+    TelemetrySlot *slots;
+    int count;                  // número de slots (um por thread de treino)
+    double interval;            // segundos entre registros
+    FILE *file;
+    bool csv;                   // formato do arquivo (false = JSONL)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool quit;                  // pedido de encerramento
+    TelemetryCounters last;     // soma dos slots no registro anterior
+    double start;               // início do treino
+    double lastTime;            // instante do registro anterior
+    long records;               // registros gravados
+} Telemetry;
+
+/**
+ * Abre o arquivo, aloca os slots e inicia a thread de gravação.
+ * @param t Telemetria.
+ * @param path Arquivo de saída (.csv grava CSV; qualquer outro, JSONL).
+ * @param slots Número de slots (um por thread de treino).
+ * @param interval Segundos entre registros (<= 0 usa TELEMETRY_DEFAULT_INTERVAL).
+ * @return true se tudo foi criado.
+ */
+bool telemetry_start(Telemetry *t, const char *path, int slots, double interval);
+
+/**
+ * Slot de uma thread de treino.
+ * @param t Telemetria (pode ser NULL).
+ * @param index Índice da thread.
+ * @return Slot, ou NULL se não há telemetria.
+ */
+static inline TelemetrySlot *telemetry_slot(Telemetry *t, int index) {
+    return t ? &t->slots[index % t->count] : NULL;
+}
+
+/**
+ * Registra um episódio concluído no slot (só a thread dona escreve nele).
+ * @param slot Slot (NULL não faz nada).
+ * @param stats Estatísticas do episódio (NULL conta só o episódio e a pontuação).
+ * @param score Pontuação final.
+ * @param epsilon Exploração usada no episódio.
+ */
+void telemetry_episode(TelemetrySlot *slot, const TrainEpisodeStats *stats, int score, float epsilon);
+
+/**
+ * Grava o último registro, encerra a thread e fecha o arquivo.
+ * @param t Telemetria.
+ */
+void telemetry_stop(Telemetry *t);
+
+#endif // TELEMETRY_H
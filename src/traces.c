@@ -0,0 +1,117 @@
+#include "traces.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Entrada inicial do índice para uma chave (hash multiplicativo de Fibonacci:
+// os log2(posições) bits altos do produto, para qualquer tamanho do índice)
+static inline int SlotOf(const TraceTable *t, int32_t key) {
+    return (int)(((uint32_t)key * 2654435769u) >> t->shift);
+}
+
+// Insere a chave do traço i no índice; a tabela nunca passa de metade cheia
+static void IndexInsert(TraceTable *t, int i) {
+    int slot = SlotOf(t, t->keys[i]);
+    while (t->slots[slot] >= 0) slot = (slot + 1) & t->mask;
+    t->slots[slot] = i;
+    t->where[i] = slot;
+}
+
+static bool Allocate(TraceTable *t, int capacity) {
+    int nslots = 2, bits = 1;
+    while (nslots < 2 * capacity) {
+        nslots <<= 1;
+        bits++;
+    }
+    int32_t *slots = (int32_t *)malloc(nslots * sizeof(int32_t));
+    int32_t *keys = (int32_t *)malloc(capacity * sizeof(int32_t));
+    int32_t *where = (int32_t *)malloc(capacity * sizeof(int32_t));
+    float *values = (float *)malloc(capacity * sizeof(float));
+    if (!slots || !keys || !where || !values) {
+        free(slots);
+        free(keys);
+        free(where);
+        free(values);
+        return false;
+    }
+    memset(slots, 0xff, nslots * sizeof(int32_t));
+
+    // Crescimento: copia os traços ativos e refaz o índice
+    int count = t->count;
+    if (count > 0) {
+        memcpy(keys, t->keys, count * sizeof(int32_t));
+        memcpy(values, t->values, count * sizeof(float));
+    }
+    free(t->slots);
+    free(t->keys);
+    free(t->where);
+    free(t->values);
+    t->slots = slots;
+    t->keys = keys;
+    t->where = where;
+    t->values = values;
+    t->capacity = capacity;
+    t->mask = nslots - 1;
+    t->shift = 32 - bits;
+    for (int i = 0; i < count; i++) IndexInsert(t, i);
+    return true;
+}
+
+bool traces_init(TraceTable *t, int capacity) {
+    memset(t, 0, sizeof(*t));
+    return Allocate(t, capacity > 0 ? capacity : TRACES_INITIAL_CAPACITY);
+}
+
+void traces_free(TraceTable *t) {
+    free(t->slots);
+    free(t->keys);
+    free(t->where);
+    free(t->values);
+    memset(t, 0, sizeof(*t));
+}
+
+void traces_clear(TraceTable *t) {
+    for (int i = 0; i < t->count; i++) t->slots[t->where[i]] = -1;
+    t->count = 0;
+}
+
+bool traces_set(TraceTable *t, int state, int action, float value) {
+    int32_t key = state * Q_STRIDE + action;
+    int slot = SlotOf(t, key);
+    for (int i; (i = t->slots[slot]) >= 0; slot = (slot + 1) & t->mask) {
+        if (t->keys[i] == key) {
+            t->values[i] = value;
+            return true;
+        }
+    }
+    if (t->count == t->capacity) {
+        if (!Allocate(t, 2 * t->capacity)) return false;
+        return traces_set(t, state, action, value);
+    }
+    int i = t->count++;
+    t->keys[i] = key;
+    t->values[i] = value;
+    t->slots[slot] = i;
+    t->where[i] = slot;
+    return true;
+}
+
+void traces_apply(TraceTable *t, QTable *Q, float step, float decay, float minTrace) {
+    /* Uma passada aplica, decai e compacta os vetores densos; o índice é
+     * esvaziado ao longo dela e refeito só com os sobreviventes (remover de
+     * uma sondagem linear no meio exigiria deslocar as vizinhas). */
+    int kept = 0;
+    for (int i = 0; i < t->count; i++) {
+        int32_t key = t->keys[i];
+        float e = t->values[i];
+        q_add(Q, key / Q_STRIDE, key % Q_STRIDE, step * e);
+        t->slots[t->where[i]] = -1;
+        e *= decay;
+        if (e >= minTrace) {
+            t->keys[kept] = key;
+            t->values[kept] = e;
+            kept++;
+        }
+    }
+    t->count = kept;
+    for (int i = 0; i < kept; i++) IndexInsert(t, i);
+}
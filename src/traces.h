@@ -0,0 +1,73 @@
+#ifndef TRACES_H
+#define TRACES_H
+
+#include "bot.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Traços de elegibilidade esparsos para Q(λ)/SARSA(λ). Só os pares
+ * (estado, ação) visitados recentemente têm traço: eles ficam em vetores
+ * densos (percorridos a cada passo) e um índice de endereçamento aberto com
+ * sondagem linear acha o traço de um par em O(1). Como os traços decaem por
+ * γλ a cada passo e são descartados abaixo de um piso, a atualização custa
+ * O(traços ativos) em vez de O(estados).
+ */
+
+#define TRACES_INITIAL_CAPACITY 256     // traços ativos antes de crescer
+#define TRACE_MIN               0.01f   // traço abaixo disso é descartado
+
+typedef struct {
+    int count;              // traços ativos
+    int capacity;           // máximo de traços ativos (metade das posições)
+    int mask;               // posições do índice - 1
+    int shift;              // 32 - log2(posições): bits altos do hash viram a posição
+    int32_t *slots;         // posição em keys/values de cada entrada do índice (-1 = vazia)
+    int32_t *keys;          // state * Q_STRIDE + action de cada traço (denso)
+    int32_t *where;         // entrada do índice de cada traço
+    float *values;          // valor de cada traço
+} TraceTable;
+
+/**
+ * Aloca a tabela de traços vazia.
+ * @param t Tabela.
+ * @param capacity Traços ativos comportados sem realocar (cresce se preciso).
+ * @return true se a alocação funcionou.
+ */
+bool traces_init(TraceTable *t, int capacity);
+
+/**
+ * Libera a tabela de traços.
+ * @param t Tabela.
+ */
+void traces_free(TraceTable *t);
+
+/**
+ * Zera todos os traços (início de episódio ou corte do Watkins Q(λ)).
+ * Custa O(traços ativos).
+ * @param t Tabela.
+ */
+void traces_clear(TraceTable *t);
+
+/**
+ * Define o traço de (s,a) (traço de substituição: e = value).
+ * @param t Tabela.
+ * @param state Estado.
+ * @param action Ação.
+ * @param value Novo valor do traço.
+ * @return false se o traço não coube e a tabela não pôde crescer.
+ */
+bool traces_set(TraceTable *t, int state, int action, float value);
+
+/**
+ * Aplica Q(s,a) += step * e(s,a) a todos os traços ativos e depois os
+ * decai por decay, descartando os que ficam abaixo de minTrace.
+ * @param t Tabela.
+ * @param Q Tabela Q.
+ * @param step alpha * erro TD.
+ * @param decay gamma * lambda.
+ * @param minTrace Piso dos traços.
+ */
+void traces_apply(TraceTable *t, QTable *Q, float step, float decay, float minTrace);
+
+#endif // TRACES_H
@@ -0,0 +1,281 @@
+#include "train.h"
+#include "bot.h"
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+// Acumula um passo nas estatísticas do episódio (q = Q(s,a) antes da atualização)
+static inline void CountStep(TrainEpisodeStats *stats, unsigned events, float reward, float q) {
+    stats->rewardSum += reward;
+    stats->qAbsSum += fabsf(q);
+    stats->paddleHits += (events & SIM_EVENT_PADDLE_HIT) != 0;
+    stats->brickHits += (events & SIM_EVENT_BRICK_HIT) != 0;
+}
+
+unsigned train_step(QTable *Q, SimState *sim, float epsilon, float alpha, float gamma, Rng *rng, TrainEpisodeStats *stats) {
+    int state = q_encode(Q, sim->paddle, sim->ball);
+    int action = choose_action(Q, state, epsilon, rng);
+    int lastScore = sim->score;
+
+    unsigned events = sim_step(sim, action);
+    bool over = (events & SIM_EVENT_GAME_OVER) != 0;
+    bool hitBrick = (events & SIM_EVENT_BRICK_HIT) != 0;
+
+    float reward = CalculateReward(sim->ball, sim->paddle, sim->score, lastScore, over, hitBrick);
+    int nextState = q_encode(Q, sim->paddle, sim->ball);
+    if (stats) CountStep(stats, events, reward, q_value(Q, state, action));
+
+    // Transição terminal: o alvo é só a recompensa, sem bootstrap
+    q_learning_update(Q, state, action, reward, nextState, alpha, over ? 0.0f : gamma, N_ACTIONS);
+    return events;
+}
+
+void train_replay_actor_init(ReplayActor *actor, ReplayBuffer *buffer, int batchSize, int updateEvery) {
+    actor->buffer = buffer;
+    actor->batchSize = batchSize > REPLAY_MAX_BATCH ? REPLAY_MAX_BATCH : (batchSize > 0 ? batchSize : 1);
+    actor->updateEvery = updateEvery > 0 ? updateEvery : 1;
+    actor->steps = 0;
+    actor->batch.n = 0;
+}
+
+unsigned train_step_replay(QTable *Q, SimState *sim, float epsilon, float alpha, float gamma, ReplayActor *actor, Rng *rng,
+                           TrainEpisodeStats *stats) {
+    int state = q_encode(Q, sim->paddle, sim->ball);
+    int action = choose_action(Q, state, epsilon, rng);
+    int lastScore = sim->score;
+
+    unsigned events = sim_step(sim, action);
+    bool over = (events & SIM_EVENT_GAME_OVER) != 0;
+    bool hitBrick = (events & SIM_EVENT_BRICK_HIT) != 0;
+
+    float reward = CalculateReward(sim->ball, sim->paddle, sim->score, lastScore, over, hitBrick);
+    int nextState = q_encode(Q, sim->paddle, sim->ball);
+    replay_push(actor->buffer, state, action, reward, nextState, over);
+    if (stats) CountStep(stats, events, reward, q_value(Q, state, action));
+
+    // Minilote só quando o buffer já tem transições suficientes
+    if (++actor->steps % actor->updateEvery == 0 && replay_size(actor->buffer) >= actor->batchSize) {
+        replay_sample(actor->buffer, &actor->batch, actor->batchSize, rng);
+        replay_update(Q, actor->buffer, &actor->batch, alpha, gamma);
+    }
+    return events;
+}
+
+bool train_trace_agent_init(TraceAgent *agent) {
+    agent->action = -1;
+    return traces_init(&agent->traces, TRACES_INITIAL_CAPACITY);
+}
+
+void train_trace_agent_free(TraceAgent *agent) {
+    traces_free(&agent->traces);
+}
+
+void train_trace_agent_reset(TraceAgent *agent) {
+    traces_clear(&agent->traces);
+    agent->action = -1;
+}
+
+unsigned train_step_lambda(QTable *Q, SimState *sim, float epsilon, const TrainParams *params, TraceAgent *agent, Rng *rng,
+                           TrainEpisodeStats *stats) {
+    int state = q_encode(Q, sim->paddle, sim->ball);
+    int action = agent->action >= 0 ? agent->action : choose_action(Q, state, epsilon, rng);
+    int lastScore = sim->score;
+
+    unsigned events = sim_step(sim, action);
+    bool over = (events & SIM_EVENT_GAME_OVER) != 0;
+    bool hitBrick = (events & SIM_EVENT_BRICK_HIT) != 0;
+
+    float reward = CalculateReward(sim->ball, sim->paddle, sim->score, lastScore, over, hitBrick);
+    int nextState = q_encode(Q, sim->paddle, sim->ball);
+
+    // Transição terminal: o alvo é só a recompensa e os traços acabam
+    float target = reward;
+    int nextAction = -1;
+    bool cut = over;
+    if (!over) {
+        nextAction = choose_action(Q, nextState, epsilon, rng);
+        float chosen = q_value(Q, nextState, nextAction);
+        if (params->learner == LEARNER_SARSA_LAMBDA) {
+            target += params->gamma * chosen;
+        } else {
+            // Empate com a gulosa conta como gulosa
+            float best = q_value(Q, nextState, greedy_action(Q, nextState));
+            target += params->gamma * best;
+            cut = chosen < best;
+        }
+    }
+
+    float current = q_value(Q, state, action);
+    float td = target - current;
+    if (stats) CountStep(stats, events, reward, current);
+    traces_set(&agent->traces, state, action, 1.0f);
+    traces_apply(&agent->traces, Q, params->alpha * td, params->gamma * params->lambda, TRACE_MIN);
+    if (cut) traces_clear(&agent->traces);
+    agent->action = nextAction;
+    return events;
+}
+
+int train_episode(QTable *Q, SimState *sim, const TrainParams *params, float epsilon, long maxSteps, TrainEpisodeStats *stats, Rng *rng,
+                  ReplayActor *replay, TraceAgent *traces) {
+    long n = 0;
+    sim_reset(sim);
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (params->learner == LEARNER_Q || replay) traces = NULL;
+    if (traces) train_trace_agent_reset(traces);
+    while (!sim->gameOver && (maxSteps <= 0 || n < maxSteps)) {
+        if (replay) train_step_replay(Q, sim, epsilon, params->alpha, params->gamma, replay, rng, stats);
+        else if (traces) train_step_lambda(Q, sim, epsilon, params, traces, rng, stats);
+        else train_step(Q, sim, epsilon, params->alpha, params->gamma, rng, stats);
+        n++;
+    }
+    if (stats) stats->steps = n;
+    return sim->score;
+}
+
+unsigned train_step_linear(LinearQ *L, SimState *sim, float epsilon, float alpha, float gamma, Rng *rng, TrainEpisodeStats *stats) {
+    float phi[LINEAR_FEATURES] __attribute__((aligned(32)));
+    float next[LINEAR_FEATURES] __attribute__((aligned(32)));
+    linear_features(sim->paddle, sim->ball, phi);
+    int action = linear_choose_action(L, phi, epsilon, rng);
+    int lastScore = sim->score;
+
+    unsigned events = sim_step(sim, action);
+    bool over = (events & SIM_EVENT_GAME_OVER) != 0;
+    bool hitBrick = (events & SIM_EVENT_BRICK_HIT) != 0;
+
+    float reward = CalculateReward(sim->ball, sim->paddle, sim->score, lastScore, over, hitBrick);
+    float target = reward;
+    if (!over) {
+        float q[N_ACTIONS];
+        linear_features(sim->paddle, sim->ball, next);
+        linear_values(L, next, q);
+        target += gamma * q[argmax(q, N_ACTIONS)];
+    }
+    float td = linear_update(L, phi, action, target, alpha);
+    if (stats) CountStep(stats, events, reward, target - td);
+    return events;
+}
+
+int train_episode_linear(LinearQ *L, SimState *sim, const TrainParams *params, float epsilon, long maxSteps,
+                         TrainEpisodeStats *stats, Rng *rng) {
+    long n = 0;
+    sim_reset(sim);
+    if (stats) memset(stats, 0, sizeof(*stats));
+    while (!sim->gameOver && (maxSteps <= 0 || n < maxSteps)) {
+        train_step_linear(L, sim, epsilon, params->alpha, params->gamma, rng, stats);
+        n++;
+    }
+    if (stats) stats->steps = n;
+    return sim->score;
+}
+
+static const char *const learnerNames[] = { "q", "qlambda", "sarsa-lambda", "linear" };
+
+const char *train_learner_name(int learner) {
+    if (learner < 0 || learner > LEARNER_LINEAR) return "?";
+    return learnerNames[learner];
+}
+
+int train_learner_parse(const char *name) {
+    for (int i = 0; i <= LEARNER_LINEAR; i++) {
+        if (strcmp(name, learnerNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+float train_decay_epsilon(const TrainParams *params, float epsilon) {
+    if (epsilon > params->minEpsilon) epsilon *= params->epsilonDecay;
+    return epsilon;
+}
+
+float train_epsilon_at(const TrainParams *params, long episode) {
+    if (params->epsilon <= params->minEpsilon || params->epsilonDecay >= 1.0f) return params->epsilon;
+    // Número de decaimentos até cruzar o piso; depois disso o valor congela
+    long k = (long)ceilf(logf(params->minEpsilon / params->epsilon) / logf(params->epsilonDecay));
+    if (k > episode) k = episode;
+    return params->epsilon * powf(params->epsilonDecay, (float)k);
+}
+
+bool train_batch_init(TrainBatch *tb, int n, float dt, uint64_t seed, const Level *level, const StateSpec *spec) {
+    if (!batch_init(&tb->env, n, dt, seed, level)) return false;
+    tb->states = (int*)malloc(n * sizeof(int));
+    tb->actions = (int*)malloc(n * sizeof(int));
+    tb->lastScore = (int*)malloc(n * sizeof(int));
+    tb->steps = (long*)calloc(n, sizeof(long));
+    tb->events = (unsigned*)calloc(n, sizeof(unsigned));
+    tb->rng = (Rng*)malloc(n * sizeof(Rng));
+    if (!tb->states || !tb->actions || !tb->lastScore || !tb->steps || !tb->events || !tb->rng) {
+        train_batch_free(tb);
+        return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        Rectangle paddle;
+        Ball ball;
+        batch_get(&tb->env, i, &paddle, &ball);
+        tb->states[i] = spec->encode(paddle, ball);
+        rng_seed(&tb->rng[i], rng_agent_seed(seed, i));
+    }
+    return true;
+}
+
+void train_batch_free(TrainBatch *tb) {
+    batch_free(&tb->env);
+    free(tb->states);
+    free(tb->actions);
+    free(tb->lastScore);
+    free(tb->steps);
+    free(tb->events);
+    free(tb->rng);
+    tb->rng = NULL;
+    tb->states = tb->actions = tb->lastScore = NULL;
+    tb->steps = NULL;
+    tb->events = NULL;
+}
+
+int train_batch_step(QTable *Q, TrainBatch *tb, float epsilon, float alpha, float gamma, long maxSteps) {
+    BatchEnv *env = &tb->env;
+    const int n = env->n;
+    int finished = 0;
+
+    for (int i = 0; i < n; i++) {
+        tb->actions[i] = choose_action(Q, tb->states[i], epsilon, &tb->rng[i]);
+        tb->lastScore[i] = env->score[i];
+    }
+
+    batch_step(env, tb->actions, tb->events);
+
+    for (int i = 0; i < n; i++) {
+        unsigned events = tb->events[i];
+        bool over = (events & SIM_EVENT_GAME_OVER) != 0;
+        bool hitBrick = (events & SIM_EVENT_BRICK_HIT) != 0;
+
+        Rectangle paddle;
+        Ball ball;
+        batch_get(env, i, &paddle, &ball);
+        int score = over ? env->episodeScore[i] : env->score[i];
+        float reward = CalculateReward(ball, paddle, score, tb->lastScore[i], over, hitBrick);
+        int nextState = q_encode(Q, paddle, ball);
+
+        // Jogos encerrados já foram reiniciados: o próximo estado é o do jogo novo
+        q_learning_update(Q, tb->states[i], tb->actions[i], reward, nextState, alpha, over ? 0.0f : gamma, N_ACTIONS);
+        tb->states[i] = nextState;
+        tb->steps[i]++;
+
+        // Episódio truncado pelo limite de passos
+        if (!over && maxSteps > 0 && tb->steps[i] >= maxSteps) {
+            env->episodeScore[i] = env->score[i];
+            batch_reset(env, i);
+            batch_get(env, i, &paddle, &ball);
+            tb->states[i] = q_encode(Q, paddle, ball);
+            tb->events[i] |= SIM_EVENT_GAME_OVER;
+            over = true;
+        }
+
+        if (over) {
+            tb->steps[i] = 0;
+            finished++;
+        }
+    }
+    return finished;
+}
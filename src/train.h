@@ -0,0 +1,259 @@
+#ifndef TRAIN_H
+#define TRAIN_H
+
+#include "sim.h"
+#include "batch.h"
+#include "bot.h"
+#include "replaybuf.h"
+#include "traces.h"
+#include "linear.h"
+
+// Parâmetros do Q-Learning
+#define ALPHA 0.1f      // Taxa de aprendizado
+#define GAMMA 0.95f     // Fator de desconto
+#define EPSILON 0.1f    // Taxa de exploração inicial
+#define EPSILON_DECAY 0.995f  // Decaimento do epsilon
+#define MIN_EPSILON 0.01f     // Epsilon mínimo
+#define LAMBDA 0.9f           // Decaimento dos traços de elegibilidade
+
+// Regras de aprendizado selecionáveis em tempo de execução
+#define LEARNER_Q            0  // Q-Learning de um passo
+#define LEARNER_Q_LAMBDA     1  // Watkins Q(λ): corta os traços em ações exploratórias
+#define LEARNER_SARSA_LAMBDA 2  // SARSA(λ): on-policy, alvo com a ação realmente escolhida
+#define LEARNER_LINEAR       3  // Q-Learning com aproximação linear (sem Q-table)
+
+// Hiperparâmetros de um treino
+typedef struct {
+    float alpha;          // taxa de aprendizado
+    float gamma;          // fator de desconto
+    float epsilon;        // exploração inicial
+    float epsilonDecay;   // decaimento por episódio
+    float minEpsilon;     // piso da exploração
+    int learner;          // regra de aprendizado (LEARNER_*)
+    float lambda;         // decaimento dos traços (Q(λ)/SARSA(λ))
+} TrainParams;
+
+#define TRAIN_PARAMS_DEFAULT { ALPHA, GAMMA, EPSILON, EPSILON_DECAY, MIN_EPSILON, LEARNER_Q, LAMBDA }
+
+// Estatísticas de um episódio (telemetria), acumuladas passo a passo
+typedef struct {
+    long steps;             // passos executados
+    double rewardSum;       // soma das recompensas
+    double qAbsSum;         // soma de |Q(s,a)| da ação tomada, antes da atualização
+    long paddleHits;        // rebatidas no paddle
+    long brickHits;         // tijolos atingidos
+} TrainEpisodeStats;
+
+/**
+ * Executa um passo do agente: codifica o estado, escolhe a ação ε-greedy,
+ * avança a simulação e atualiza a Q-table com a transição observada.
+ * @param Q Tabela Q.
+ * @param sim Estado da simulação (não pode estar em game over).
+ * @param epsilon Probabilidade de exploração neste passo.
+ * @param alpha Taxa de aprendizado.
+ * @param gamma Fator de desconto.
+ * @param rng Gerador do agente (exploração).
+ * @param stats Estatísticas do episódio a acumular (pode ser NULL).
+ * @return Bitmask de SIM_EVENT_* produzidos pelo passo.
+ */
+unsigned train_step(QTable *Q, SimState *sim, float epsilon, float alpha, float gamma, Rng *rng, TrainEpisodeStats *stats);
+
+// Ator que aprende por buffer de experiência: guarda cada transição no buffer
+// (que pode ser compartilhado entre threads) e, a cada updateEvery passos,
+// aplica um minilote amostrado dele em vez da transição recém-vista
+typedef struct {
+    ReplayBuffer *buffer;
+    int batchSize;          // transições por minilote
+    int updateEvery;        // passos do ator entre minilotes
+    long steps;             // passos já dados pelo ator
+    ReplayBatch batch;      // área do minilote (uma por ator)
+} ReplayActor;
+
+/**
+ * Prepara um ator de buffer de experiência.
+ * @param actor Ator.
+ * @param buffer Buffer compartilhado.
+ * @param batchSize Transições por minilote (até REPLAY_MAX_BATCH).
+ * @param updateEvery Passos entre minilotes (>= 1).
+ */
+void train_replay_actor_init(ReplayActor *actor, ReplayBuffer *buffer, int batchSize, int updateEvery);
+
+/**
+ * Como train_step, mas a transição vai para o buffer do ator e a Q-table é
+ * atualizada por minilotes.
+ * @param Q Tabela Q.
+ * @param sim Estado da simulação (não pode estar em game over).
+ * @param epsilon Probabilidade de exploração neste passo.
+ * @param alpha Taxa de aprendizado.
+ * @param gamma Fator de desconto.
+ * @param actor Ator de buffer de experiência.
+ * @param rng Gerador do agente (exploração e amostragem).
+ * @param stats Estatísticas do episódio a acumular (pode ser NULL).
+ * @return Bitmask de SIM_EVENT_* produzidos pelo passo.
+ */
+unsigned train_step_replay(QTable *Q, SimState *sim, float epsilon, float alpha, float gamma, ReplayActor *actor, Rng *rng,
+                           TrainEpisodeStats *stats);
+
+// Agente com traços de elegibilidade. A ação do próximo estado é escolhida
+// antes da atualização: o SARSA(λ) a usa no alvo e o Q(λ) corta os traços
+// quando ela é exploratória; ela é executada no passo seguinte.
+typedef struct {
+    TraceTable traces;
+    int action;             // ação já escolhida para o estado atual (-1 = nenhuma)
+} TraceAgent;
+
+/**
+ * Prepara um agente de traços.
+ * @param agent Agente.
+ * @return true se a alocação funcionou.
+ */
+bool train_trace_agent_init(TraceAgent *agent);
+
+/**
+ * Libera o agente de traços.
+ * @param agent Agente.
+ */
+void train_trace_agent_free(TraceAgent *agent);
+
+/**
+ * Zera os traços e a ação pendente (início de episódio).
+ * @param agent Agente.
+ */
+void train_trace_agent_reset(TraceAgent *agent);
+
+/**
+ * Passo de treino com traços de elegibilidade (params->learner escolhe entre
+ * Q(λ) e SARSA(λ)). Atualiza todos os pares com traço ativo.
+ * @param Q Tabela Q.
+ * @param sim Estado da simulação (não pode estar em game over).
+ * @param epsilon Probabilidade de exploração neste passo.
+ * @param params Hiperparâmetros (alpha, gamma, lambda, learner).
+ * @param agent Agente de traços.
+ * @param rng Gerador do agente (exploração).
+ * @param stats Estatísticas do episódio a acumular (pode ser NULL).
+ * @return Bitmask de SIM_EVENT_* produzidos pelo passo.
+ */
+unsigned train_step_lambda(QTable *Q, SimState *sim, float epsilon, const TrainParams *params, TraceAgent *agent, Rng *rng,
+                           TrainEpisodeStats *stats);
+
+/**
+ * Joga um episódio completo a partir de um jogo novo.
+ * @param Q Tabela Q.
+ * @param sim Estado da simulação (é reiniciado no início).
+ * @param params Hiperparâmetros.
+ * @param epsilon Exploração usada durante o episódio.
+ * @param maxSteps Limite de passos do episódio (<= 0 para ilimitado).
+ * @param stats Saída opcional com as estatísticas do episódio (passos,
+ *              recompensa, |Q|, colisões).
+ * @param rng Gerador do agente (exploração).
+ * @param replay Ator de buffer de experiência (NULL atualiza a cada passo).
+ * @param traces Agente de traços, usado quando params->learner não é LEARNER_Q
+ *               e não há replay (NULL cai no Q-Learning de um passo).
+ * @return Pontuação final do episódio.
+ */
+int train_episode(QTable *Q, SimState *sim, const TrainParams *params, float epsilon, long maxSteps, TrainEpisodeStats *stats, Rng *rng,
+                  ReplayActor *replay, TraceAgent *traces);
+
+/**
+ * Passo de treino do agente linear: features do estado, ação ε-greedy,
+ * simulação e passo de gradiente com o alvo do Q-Learning.
+ * @param L Pesos.
+ * @param sim Estado da simulação (não pode estar em game over).
+ * @param epsilon Probabilidade de exploração neste passo.
+ * @param alpha Taxa de aprendizado.
+ * @param gamma Fator de desconto.
+ * @param rng Gerador do agente (exploração).
+ * @param stats Estatísticas do episódio a acumular (pode ser NULL).
+ * @return Bitmask de SIM_EVENT_* produzidos pelo passo.
+ */
+unsigned train_step_linear(LinearQ *L, SimState *sim, float epsilon, float alpha, float gamma, Rng *rng, TrainEpisodeStats *stats);
+
+/**
+ * Joga um episódio completo com o agente linear.
+ * @param L Pesos.
+ * @param sim Estado da simulação (é reiniciado no início).
+ * @param params Hiperparâmetros.
+ * @param epsilon Exploração usada durante o episódio.
+ * @param maxSteps Limite de passos do episódio (<= 0 para ilimitado).
+ * @param stats Saída opcional com as estatísticas do episódio.
+ * @param rng Gerador do agente (exploração).
+ * @return Pontuação final do episódio.
+ */
+int train_episode_linear(LinearQ *L, SimState *sim, const TrainParams *params, float epsilon, long maxSteps,
+                         TrainEpisodeStats *stats, Rng *rng);
+
+/**
+ * Nome de uma regra de aprendizado (para mensagens e --learner).
+ * @param learner LEARNER_*.
+ * @return Nome curto ("q", "qlambda", "sarsa-lambda" ou "linear").
+ */
+const char *train_learner_name(int learner);
+
+/**
+ * Converte um nome de --learner em LEARNER_*.
+ * @param name Nome curto.
+ * @return LEARNER_* correspondente, ou -1 se desconhecido.
+ */
+int train_learner_parse(const char *name);
+
+/**
+ * Aplica o decaimento de epsilon do fim de um episódio.
+ * @param params Hiperparâmetros.
+ * @param epsilon Valor atual.
+ * @return Novo valor de epsilon.
+ */
+float train_decay_epsilon(const TrainParams *params, float epsilon);
+
+/**
+ * Valor de epsilon no início do episódio de índice dado (0 = primeiro),
+ * equivalente a aplicar train_decay_epsilon episódio a episódio.
+ * @param params Hiperparâmetros.
+ * @param episode Índice do episódio.
+ * @return Epsilon desse episódio.
+ */
+float train_epsilon_at(const TrainParams *params, long episode);
+
+// Treino com um lote de jogos compartilhando a mesma Q-table
+typedef struct {
+    BatchEnv env;
+    int *states;        // estado codificado atual de cada jogo
+    int *actions;       // ação escolhida no passo corrente
+    int *lastScore;     // pontuação antes do passo
+    long *steps;        // passos do episódio corrente de cada jogo
+    unsigned *events;   // eventos do último passo
+    Rng *rng;           // gerador do agente de cada jogo (rng_agent_seed(seed, i))
+} TrainBatch;
+
+/**
+ * Aloca um lote de treino com n jogos.
+ * @param tb Lote de treino.
+ * @param n Número de jogos.
+ * @param dt Passo fixo (<= 0 usa SIM_DT).
+ * @param seed Semente dos jogos e do agente.
+ * @param level Nível jogado (NULL = embutido).
+ * @param spec Discretização da Q-table que o lote vai treinar.
+ * @return true se a alocação funcionou.
+ */
+bool train_batch_init(TrainBatch *tb, int n, float dt, uint64_t seed, const Level *level, const StateSpec *spec);
+
+/**
+ * Libera o lote de treino.
+ * @param tb Lote de treino.
+ */
+void train_batch_free(TrainBatch *tb);
+
+/**
+ * Executa um passo de treino em todos os jogos do lote. Jogos que perdem ou
+ * atingem maxSteps recomeçam e ficam marcados com SIM_EVENT_GAME_OVER em
+ * tb->events; a pontuação final fica em tb->env.episodeScore.
+ * @param Q Tabela Q.
+ * @param tb Lote de treino.
+ * @param epsilon Probabilidade de exploração.
+ * @param alpha Taxa de aprendizado.
+ * @param gamma Fator de desconto.
+ * @param maxSteps Limite de passos por episódio (<= 0 para ilimitado).
+ * @return Número de episódios encerrados neste passo.
+ */
+int train_batch_step(QTable *Q, TrainBatch *tb, float epsilon, float alpha, float gamma, long maxSteps);
+
+#endif // TRAIN_H
@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trainer.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Intervalo entre linhas de progresso (s)
+#define TRAINER_REPORT_SECONDS 1.0
+
+// Contadores compartilhados entre as threads
+typedef struct {
+    long nextEpisode;       // próximo episódio a ser reservado
+    long doneEpisodes;      // episódios concluídos
+    long scoreSum;          // soma das pontuações concluídas
+    long steps;             // passos simulados
+} TrainerShared;
+
+// Estado de uma thread; alinhado para não dividir linha de cache com as vizinhas
+typedef struct {
+    pthread_t thread;
+    int id;
+    QTable *Q;
+    const TrainerConfig *cfg;
+    TrainerShared *shared;
+    TrainerStats stats;
+} __attribute__((aligned(64))) TrainerWorker;
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void SleepSeconds(double s) {
+    struct timespec ts = { (time_t)s, (long)((s - (time_t)s) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+static void *WorkerMain(void *arg) {
+    TrainerWorker *w = (TrainerWorker *)arg;
+    const TrainerConfig *cfg = w->cfg;
+    TrainerShared *shared = w->shared;
+
+    uint64_t seed = rng_resume_seed(cfg->seed, cfg->firstEpisode);
+    SimState sim;
+    Rng rng;
+    sim_init(&sim, cfg->dt, rng_env_seed(seed, w->id));
+    sim.collision = cfg->collision;
+    sim_set_level(&sim, cfg->level);
+    rng_seed(&rng, rng_agent_seed(seed, w->id));
+    __atomic_store_n(&w->stats.simRng, sim.rng.state, __ATOMIC_RELAXED);
+    __atomic_store_n(&w->stats.agentRng, rng.state, __ATOMIC_RELAXED);
+
+    ReplayActor actor;
+    if (cfg->replay) train_replay_actor_init(&actor, cfg->replay, cfg->replayBatch, cfg->replayEvery);
+    TraceAgent traces;
+    bool useTraces = cfg->params.learner != LEARNER_Q && !cfg->replay && !cfg->linear && train_trace_agent_init(&traces);
+
+    TelemetrySlot *slot = telemetry_slot(cfg->telemetry, w->id);
+    double start = NowSeconds();
+    for (;;) {
+        long episode = __atomic_fetch_add(&shared->nextEpisode, 1, __ATOMIC_RELAXED);
+        if (episode >= cfg->episodes) break;
+
+        float epsilon = train_epsilon_at(&cfg->params, episode);
+        TrainEpisodeStats es;
+        int score = cfg->linear
+                  ? train_episode_linear(cfg->linear, &sim, &cfg->params, epsilon, cfg->maxSteps, &es, &rng)
+                  : train_episode(w->Q, &sim, &cfg->params, epsilon, cfg->maxSteps, &es, &rng,
+                                  cfg->replay ? &actor : NULL, useTraces ? &traces : NULL);
+        telemetry_episode(slot, &es, score, epsilon);
+
+        w->stats.episodes++;
+        w->stats.steps += es.steps;
+        w->stats.scoreSum += score;
+        // Publicados para os checkpoints, que guardam os geradores da thread 0
+        __atomic_store_n(&w->stats.simRng, sim.rng.state, __ATOMIC_RELAXED);
+        __atomic_store_n(&w->stats.agentRng, rng.state, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&shared->scoreSum, score, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&shared->steps, es.steps, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&shared->doneEpisodes, 1, __ATOMIC_RELEASE);
+    }
+    w->stats.seconds = NowSeconds() - start;
+    if (useTraces) train_trace_agent_free(&traces);
+    return NULL;
+}
+
+bool trainer_run(QTable *Q, const TrainerConfig *cfg, TrainerStats *stats) {
+    int n = cfg->threads > 0 ? cfg->threads : 1;
+    TrainerShared shared = { cfg->firstEpisode, cfg->firstEpisode, 0, 0 };
+
+    TrainerWorker *workers = NULL;
+    if (posix_memalign((void **)&workers, 64, n * sizeof(TrainerWorker)) != 0) return false;
+    memset(workers, 0, n * sizeof(TrainerWorker));
+
+    int started = 0;
+    for (int i = 0; i < n; i++) {
+        workers[i].id = i;
+        workers[i].Q = Q;
+        workers[i].cfg = cfg;
+        workers[i].shared = &shared;
+        if (pthread_create(&workers[i].thread, NULL, WorkerMain, &workers[i]) != 0) break;
+        started++;
+    }
+    if (started < n) {
+        // Sem todas as threads: faz as criadas pararem logo e desiste
+        __atomic_store_n(&shared.nextEpisode, cfg->episodes, __ATOMIC_RELAXED);
+    }
+
+    // Progresso agregado enquanto as threads treinam
+    double start = NowSeconds();
+    double lastReport = start;
+    long lastDone = cfg->firstEpisode, lastScore = 0;
+    long lastCheckpoint = cfg->firstEpisode;
+    while (started == n) {
+        long done = __atomic_load_n(&shared.doneEpisodes, __ATOMIC_ACQUIRE);
+        if (done >= cfg->episodes) break;
+        SleepSeconds(0.05);
+
+        double now = NowSeconds();
+        if (now - lastReport >= TRAINER_REPORT_SECONDS) {
+            done = __atomic_load_n(&shared.doneEpisodes, __ATOMIC_ACQUIRE);
+            long scoreSum = __atomic_load_n(&shared.scoreSum, __ATOMIC_RELAXED);
+            long delta = done - lastDone;
+            printf("Episódio %ld - Score médio: %.2f - Epsilon: %.3f - %.0f ep/s\n",
+                   done, delta > 0 ? (float)(scoreSum - lastScore) / delta : 0.0f,
+                   train_epsilon_at(&cfg->params, done), delta / (now - lastReport));
+            lastReport = now;
+            lastDone = done;
+            lastScore = scoreSum;
+        }
+
+        // Snapshot sem parar as threads (leitura Hogwild da Q-table)
+        if (Q && cfg->checkpoint && cfg->checkpointEvery > 0 && done - lastCheckpoint >= cfg->checkpointEvery) {
+            QTableMeta meta;
+            memset(&meta, 0, sizeof(meta));
+            meta.alpha = cfg->params.alpha;
+            meta.gamma = cfg->params.gamma;
+            meta.epsilon = train_epsilon_at(&cfg->params, done);
+            meta.episodes = done;
+            meta.steps = cfg->firstSteps + __atomic_load_n(&shared.steps, __ATOMIC_RELAXED);
+            meta.seed = cfg->seed;
+            meta.simRng = __atomic_load_n(&workers[0].stats.simRng, __ATOMIC_RELAXED);
+            meta.agentRng = __atomic_load_n(&workers[0].stats.agentRng, __ATOMIC_RELAXED);
+            if (checkpoint_submit(cfg->checkpoint, Q, &meta, false)) lastCheckpoint = done;
+        }
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (started == n) {
+        // Escalabilidade: episódios por segundo de cada thread
+        for (int i = 0; i < n; i++) {
+            const TrainerStats *s = &workers[i].stats;
+            printf("Thread %2d: %ld episódios, %.1f ep/s, %.0f passos/s\n", i, s->episodes,
+                   s->seconds > 0.0 ? s->episodes / s->seconds : 0.0,
+                   s->seconds > 0.0 ? s->steps / s->seconds : 0.0);
+            if (stats) stats[i] = *s;
+        }
+    }
+
+    free(workers);
+    return started == n;
+}
@@ -0,0 +1,58 @@
+#ifndef TRAINER_H
+#define TRAINER_H
+
+#include "train.h"
+#include "bot.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include <stdint.h>
+
+/*
+ * Treino paralelo: uma simulação por thread, todas atualizando a mesma
+ * Q-table sem locks (estilo Hogwild!). Os episódios são distribuídos por um
+ * contador atômico e o epsilon de cada um depende só do seu índice global,
+ * então o cronograma de decaimento é o mesmo do treino sequencial.
+ */
+
+// Configuração de um treino paralelo
+typedef struct {
+    int threads;            // número de threads de treino
+    long episodes;          // episódio final (somando todas as threads)
+    long maxSteps;          // limite de passos por episódio (<= 0 ilimitado)
+    float dt;               // passo fixo da simulação
+    int collision;          // modo de colisão (SIM_COLLISION_*)
+    uint64_t seed;          // semente base (cada thread deriva a sua)
+    TrainParams params;     // hiperparâmetros
+    long firstEpisode;      // episódios já treinados (retomada de checkpoint)
+    long firstSteps;        // passos já treinados (retomada de checkpoint)
+    Checkpointer *checkpoint; // checkpoints periódicos (pode ser NULL)
+    long checkpointEvery;   // episódios entre checkpoints
+    ReplayBuffer *replay;   // buffer de experiência compartilhado (NULL = online)
+    int replayBatch;        // transições por minilote
+    int replayEvery;        // passos entre minilotes de cada thread
+    LinearQ *linear;        // pesos do agente linear (não NULL: a Q-table não é usada)
+    Telemetry *telemetry;   // um slot por thread (pode ser NULL)
+    const Level *level;     // nível compartilhado pelas threads (NULL = embutido)
+} TrainerConfig;
+
+// Estatísticas de uma thread ao final do treino
+typedef struct {
+    long episodes;          // episódios jogados
+    long steps;             // passos simulados
+    long scoreSum;          // soma das pontuações
+    double seconds;         // tempo de parede da thread
+    uint64_t simRng;        // gerador do jogo ao fim do último episódio
+    uint64_t agentRng;      // gerador do agente ao fim do último episódio
+} TrainerStats;
+
+/**
+ * Executa o treino paralelo e bloqueia até o fim, imprimindo o progresso.
+ * @param Q Tabela Q compartilhada (pode ser NULL com cfg->linear).
+ * @param cfg Configuração.
+ * @param stats Vetor com cfg->threads posições para as estatísticas por thread
+ *              (pode ser NULL).
+ * @return true se todas as threads foram criadas.
+ */
+bool trainer_run(QTable *Q, const TrainerConfig *cfg, TrainerStats *stats);
+
+#endif // TRAINER_H
@@ -0,0 +1,49 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Verificações dos testes: uma falha é contada e impressa com arquivo e
+ * linha, e o teste continua (um só executável roda todas as suítes).
+ */
+
+extern int check_failures;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            check_failures++; \
+        } \
+    } while (0)
+
+// Suítes (uma por arquivo tests/test_*.c)
+void test_batch(void);
+void test_actionlog(void);
+void test_files(void);
+void test_replaybuf(void);
+void test_traces(void);
+
+/**
+ * Copia um arquivo, opcionalmente cortando o fim.
+ * @param from Origem.
+ * @param to Destino.
+ * @param drop Bytes descartados do fim da origem.
+ * @return true se copiou.
+ */
+bool check_copy_file(const char *from, const char *to, long drop);
+
+/**
+ * Sobrescreve bytes de um arquivo.
+ * @param path Arquivo.
+ * @param offset Posição.
+ * @param data Bytes novos.
+ * @param size Quantidade.
+ * @return true se gravou.
+ */
+bool check_patch_file(const char *path, long offset, const void *data, size_t size);
+
+#endif // CHECK_H
@@ -0,0 +1,62 @@
+#include "check.h"
+#include "batch.h"
+#include "sim.h"
+
+/*
+ * O lote SoA tem de andar bit a bit junto com sim_step: mesmas sementes
+ * (rng_env_seed), mesmas ações, mesmos eventos, bola e pontuação a cada passo.
+ */
+
+#define BATCH_GAMES 8
+#define BATCH_STEPS 50000
+
+static void CheckAgainstSim(const Level *level) {
+    BatchEnv env;
+    bool ok = batch_init(&env, BATCH_GAMES, SIM_DT, 7, level);
+    CHECK(ok);
+    if (!ok) return;
+    SimState sim[BATCH_GAMES];
+    for (int i = 0; i < BATCH_GAMES; i++) {
+        sim_init(&sim[i], SIM_DT, rng_env_seed(7, i));
+        sim_set_level(&sim[i], level);
+    }
+
+    Rng actions;
+    rng_seed(&actions, 99);
+    int action[BATCH_GAMES];
+    unsigned events[BATCH_GAMES];
+    long diverged = 0, bricks = 0, episodes = 0;
+    for (long t = 0; t < BATCH_STEPS; t++) {
+        for (int i = 0; i < BATCH_GAMES; i++) action[i] = rng_range(&actions, 0, 2);
+        batch_step(&env, action, events);
+        for (int i = 0; i < BATCH_GAMES; i++) {
+            unsigned expected = sim_step(&sim[i], action[i]);
+            if (expected & SIM_EVENT_BRICK_HIT) bricks++;
+            if (expected != events[i]) diverged++;
+            if (sim[i].gameOver) {
+                // O lote reinicia sozinho e guarda a pontuação do episódio
+                episodes++;
+                if (env.episodeScore[i] != sim[i].score) diverged++;
+                sim_reset(&sim[i]);
+            }
+            if (sim[i].ball.pos.x != env.ballX[i] || sim[i].ball.pos.y != env.ballY[i]
+                || sim[i].paddle.x != env.paddleX[i] || sim[i].score != env.score[i])
+                diverged++;
+        }
+    }
+    CHECK(diverged == 0);
+    CHECK(bricks > 0);      // o teste só vale se houve tijolos atingidos
+    CHECK(episodes > 0);
+    batch_free(&env);
+}
+
+void test_batch(void) {
+    CheckAgainstSim(level_builtin());
+
+    // Grade grande com tijolos de vários pontos de vida (planos de acertos)
+    Level grid;
+    CHECK(level_grid(&grid, 12, 70));
+    CHECK(grid.multiHit);
+    CheckAgainstSim(&grid);
+    level_free(&grid);
+}
@@ -0,0 +1,207 @@
+#include "check.h"
+#include "bot.h"
+#include "level.h"
+#include "policy.h"
+#include "qtable_io.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Formatos binários (Q-table v2, ARKLVL1, ARKPOL1): o arquivo gravado volta
+ * igual, e arquivos truncados ou corrompidos são recusados em vez de
+ * carregados pela metade.
+ */
+
+#define QTABLE_PATH "test_qtable.tmp"
+#define LEVEL_PATH  "test_level.tmp"
+#define POLICY_PATH "test_policy.tmp"
+#define BROKEN_PATH "test_broken.tmp"
+
+// Q-table com valores distintos por estado e ação
+static QTable *FilledTable(void) {
+    QTable *Q = init_q_table(NULL);
+    if (!Q) return NULL;
+    for (int s = 0; s < Q->nStates; s++) {
+        for (int a = 0; a < N_ACTIONS; a++) q_add(Q, s, a, (float)((s * 7 + a * 3) % 11) - 5.0f);
+    }
+    return Q;
+}
+
+static bool SameValues(const QTable *A, const QTable *B) {
+    if (A->nStates != B->nStates) return false;
+    for (int s = 0; s < A->nStates; s++) {
+        for (int a = 0; a < N_ACTIONS; a++) {
+            if (q_value(A, s, a) != q_value(B, s, a)) return false;
+        }
+    }
+    return true;
+}
+
+// map_qtable nos dois modos e load_qtable recusam o arquivo
+static bool Rejected(const char *path, bool verifiedOnly) {
+    QTable *mapped = map_qtable(path, NULL, true);
+    QTable *unverified = verifiedOnly ? NULL : map_qtable(path, NULL, false);
+    QTable *Q = init_q_table(NULL);
+    bool loaded = Q && load_qtable(Q, path);
+    bool rejected = !mapped && !unverified && !loaded;
+    free_q_table(mapped);
+    free_q_table(unverified);
+    free_q_table(Q);
+    return rejected;
+}
+
+static void TestQTable(void) {
+    QTable *Q = FilledTable();
+    CHECK(Q != NULL);
+    if (!Q) return;
+    QTableMeta meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.episodes = 1234;
+    meta.steps = 56789;
+    CHECK(save_qtable_meta(Q, &meta, QTABLE_PATH));
+
+    QTableMeta readMeta;
+    QTable *M = map_qtable(QTABLE_PATH, &readMeta, true);
+    CHECK(M && SameValues(Q, M) && readMeta.episodes == 1234 && readMeta.steps == 56789);
+    free_q_table(M);
+    QTable *L = init_q_table(NULL);
+    CHECK(L && load_qtable(L, QTABLE_PATH) && SameValues(Q, L));
+    free_q_table(L);
+
+    // Truncado: as linhas não cabem no arquivo
+    CHECK(check_copy_file(QTABLE_PATH, BROKEN_PATH, 64));
+    CHECK(Rejected(BROKEN_PATH, false));
+
+    // Cabeçalho alterado (nStates): o CRC do cabeçalho não bate
+    uint32_t states = 7;
+    CHECK(check_copy_file(QTABLE_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, (long)offsetof(QTableFileHeader, nStates), &states, sizeof(states)));
+    CHECK(Rejected(BROKEN_PATH, false));
+
+    // Um valor da linha alterado: só o CRC das linhas percebe
+    float value = 99.0f;
+    CHECK(check_copy_file(QTABLE_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, QTABLE_DATA_ALIGN + 5 * Q_STRIDE * (long)sizeof(float), &value, sizeof(value)));
+    CHECK(Rejected(BROKEN_PATH, true));
+
+    // Padding diferente de -INFINITY: recusado mesmo sem conferir o CRC
+    CHECK(check_copy_file(QTABLE_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, QTABLE_DATA_ALIGN + (5 * Q_STRIDE + N_ACTIONS) * (long)sizeof(float), &value,
+                           sizeof(value)));
+    CHECK(Rejected(BROKEN_PATH, false));
+
+    free_q_table(Q);
+    remove(QTABLE_PATH);
+    remove(BROKEN_PATH);
+}
+
+static bool LevelRejected(const char *path) {
+    Level level;
+    char err[256];
+    bool loaded = level_load(&level, path, err, sizeof(err));
+    if (loaded) level_free(&level);
+    return !loaded;
+}
+
+static void TestLevel(void) {
+    Level grid;
+    CHECK(level_grid(&grid, 6, 24));
+    CHECK(level_save(&grid, LEVEL_PATH));
+
+    Level level;
+    char err[256];
+    bool loaded = level_load(&level, LEVEL_PATH, err, sizeof(err));
+    CHECK(loaded);
+    if (loaded) {
+        CHECK(level.rows == grid.rows && level.cols == grid.cols && level.multiHit == grid.multiHit);
+        CHECK(memcmp(level.cells, grid.cells, (size_t)grid.rows * grid.cols) == 0);
+        CHECK(level_hash(&level) == level_hash(&grid));
+        level_free(&level);
+    }
+
+    // Truncado no meio das células
+    CHECK(check_copy_file(LEVEL_PATH, BROKEN_PATH, 10));
+    CHECK(LevelRejected(BROKEN_PATH));
+
+    // Assinatura errada
+    CHECK(check_copy_file(LEVEL_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, 0, "ARKLVL9", 7));
+    CHECK(LevelRejected(BROKEN_PATH));
+
+    // Dimensões fora do limite
+    uint16_t rows = LEVEL_MAX_ROWS + 1;
+    CHECK(check_copy_file(LEVEL_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, (long)offsetof(LevelFileHeader, rows), &rows, sizeof(rows)));
+    CHECK(LevelRejected(BROKEN_PATH));
+
+    // Tijolo com mais vida que LEVEL_MAX_HP
+    uint8_t cell = LEVEL_CELL(0, LEVEL_MAX_HP + 1);
+    long cells = (long)sizeof(LevelFileHeader) + grid.paletteCount * (long)sizeof(Color);
+    CHECK(check_copy_file(LEVEL_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, cells + 3, &cell, 1));
+    CHECK(LevelRejected(BROKEN_PATH));
+
+    level_free(&grid);
+    remove(LEVEL_PATH);
+    remove(BROKEN_PATH);
+}
+
+static bool PolicyRejected(const char *path) {
+    Policy policy;
+    bool loaded = policy_load(&policy, path);
+    if (loaded) policy_free(&policy);
+    return !loaded;
+}
+
+static void TestPolicy(void) {
+    QTable *Q = FilledTable();
+    Policy policy;
+    CHECK(Q && policy_compile(&policy, Q, true));
+    if (!Q) return;
+    CHECK(policy_save(&policy, POLICY_PATH));
+
+    Policy loaded;
+    CHECK(policy_load(&loaded, POLICY_PATH));
+    if (loaded.actions) {
+        bool same = loaded.spec == policy.spec && loaded.margins != NULL;
+        for (int s = 0; same && s < Q->nStates; s++) {
+            same = policy_action(&loaded, s) == policy_action(&policy, s)
+                && policy_action(&loaded, s) == greedy_action(Q, s);
+        }
+        CHECK(same);
+        policy_free(&loaded);
+    }
+
+    // Truncado nas margens
+    CHECK(check_copy_file(POLICY_PATH, BROKEN_PATH, 1));
+    CHECK(PolicyRejected(BROKEN_PATH));
+
+    // Assinatura errada
+    CHECK(check_copy_file(POLICY_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, 0, "ARKPOL9", 7));
+    CHECK(PolicyRejected(BROKEN_PATH));
+
+    // Discretização desconhecida
+    uint32_t specId = 0xDEADBEEFu;
+    CHECK(check_copy_file(POLICY_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, (long)offsetof(PolicyFileHeader, specId), &specId, sizeof(specId)));
+    CHECK(PolicyRejected(BROKEN_PATH));
+
+    // Valor 3 (não é ação) nos 2 bits de um estado
+    uint8_t actions = 0xFF;
+    CHECK(check_copy_file(POLICY_PATH, BROKEN_PATH, 0));
+    CHECK(check_patch_file(BROKEN_PATH, (long)sizeof(PolicyFileHeader), &actions, 1));
+    CHECK(PolicyRejected(BROKEN_PATH));
+
+    policy_free(&policy);
+    free_q_table(Q);
+    remove(POLICY_PATH);
+    remove(BROKEN_PATH);
+}
+
+void test_files(void) {
+    TestQTable();
+    TestLevel();
+    TestPolicy();
+}
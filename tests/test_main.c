@@ -0,0 +1,63 @@
+#include "check.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Testes do núcleo headless. Sem argumentos roda todas as suítes; com um
+ * nome roda só aquela (o CTest registra uma entrada por suíte).
+ */
+
+int check_failures = 0;
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} Suite;
+
+static const Suite SUITES[] = {
+    { "batch", test_batch },
+    { "actionlog", test_actionlog },
+    { "files", test_files },
+    { "replaybuf", test_replaybuf },
+    { "traces", test_traces },
+};
+#define SUITE_COUNT ((int)(sizeof(SUITES) / sizeof(SUITES[0])))
+
+bool check_copy_file(const char *from, const char *to, long drop) {
+    FILE *in = fopen(from, "rb");
+    if (!in) return false;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in) - drop;
+    rewind(in);
+    char *data = (char *)malloc(size > 0 ? (size_t)size : 1);
+    bool ok = data && size >= 0 && fread(data, 1, (size_t)size, in) == (size_t)size;
+    fclose(in);
+    FILE *out = ok ? fopen(to, "wb") : NULL;
+    ok = out && fwrite(data, 1, (size_t)size, out) == (size_t)size;
+    if (out) ok = (fclose(out) == 0) && ok;
+    free(data);
+    return ok;
+}
+
+bool check_patch_file(const char *path, long offset, const void *data, size_t size) {
+    FILE *file = fopen(path, "r+b");
+    if (!file) return false;
+    bool ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(data, 1, size, file) == size;
+    return (fclose(file) == 0) && ok;
+}
+
+int main(int argc, char **argv) {
+    int ran = 0;
+    for (int i = 0; i < SUITE_COUNT; i++) {
+        if (argc > 1 && strcmp(argv[1], SUITES[i].name) != 0) continue;
+        int before = check_failures;
+        SUITES[i].run();
+        printf("%-10s %s\n", SUITES[i].name, check_failures == before ? "ok" : "FALHOU");
+        ran++;
+    }
+    if (ran == 0) {
+        fprintf(stderr, "Suíte desconhecida: %s\n", argv[1]);
+        return 2;
+    }
+    return check_failures == 0 ? 0 : 1;
+}
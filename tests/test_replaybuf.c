@@ -0,0 +1,83 @@
+#include "check.h"
+#include "replaybuf.h"
+#include <math.h>
+
+/*
+ * Pesos de importância da amostragem priorizada: cada peso é
+ * (p_i / p_min)^-beta com a prioridade da própria posição amostrada, fica em
+ * (0, 1] e vale 1 na de menor prioridade do minilote. Sem priorização todos
+ * valem 1.
+ */
+
+#define REPLAY_TEST_CAPACITY 1024
+#define REPLAY_TEST_BATCH    64
+#define REPLAY_TEST_BETA     0.4f
+
+static void Fill(ReplayBuffer *rb) {
+    for (int i = 0; i < REPLAY_TEST_CAPACITY; i++) replay_push(rb, i % 97, i % N_ACTIONS, 1.0f, (i + 1) % 97, false);
+}
+
+// Confere os pesos contra as prioridades das posições sorteadas
+static bool WeightsMatch(const ReplayBuffer *rb, const ReplayBatch *batch) {
+    float minPrio = INFINITY;
+    for (int k = 0; k < batch->n; k++) minPrio = fminf(minPrio, rb->priority[batch->slot[k]]);
+    bool ok = batch->n > 0;
+    for (int k = 0; k < batch->n; k++) {
+        float expected = powf(rb->priority[batch->slot[k]] / minPrio, -rb->priorityBeta);
+        float w = batch->weight[k];
+        ok = ok && w > 0.0f && w <= 1.0f && fabsf(w - expected) <= 1e-5f * expected;
+    }
+    return ok;
+}
+
+void test_replaybuf(void) {
+    Rng rng;
+    rng_seed(&rng, 3);
+    ReplayBatch batch;
+
+    // Uniforme: pesos 1
+    ReplayBuffer uniform;
+    CHECK(replay_init(&uniform, REPLAY_TEST_CAPACITY, 0.0f, REPLAY_TEST_BETA));
+    Fill(&uniform);
+    CHECK(replay_sample(&uniform, &batch, REPLAY_TEST_BATCH, &rng) == REPLAY_TEST_BATCH);
+    bool ones = true;
+    for (int k = 0; k < batch.n; k++) ones = ones && batch.weight[k] == 1.0f;
+    CHECK(ones);
+    replay_free(&uniform);
+
+    // Priorizado: prioridades bem diferentes entre as posições
+    ReplayBuffer rb;
+    CHECK(replay_init(&rb, REPLAY_TEST_CAPACITY, 0.6f, REPLAY_TEST_BETA));
+    Fill(&rb);
+    for (int i = 0; i < REPLAY_TEST_CAPACITY; i++) rb.priority[i] = 0.05f + (float)(i % 32) / 8.0f;
+    rb.maxPriority = 0.05f + 31.0f / 8.0f;
+    for (int round = 0; round < 20; round++) {
+        CHECK(replay_sample(&rb, &batch, REPLAY_TEST_BATCH, &rng) == REPLAY_TEST_BATCH);
+        CHECK(WeightsMatch(&rb, &batch));
+        // A de menor prioridade do minilote tem peso 1
+        float best = 0.0f;
+        for (int k = 0; k < batch.n; k++) best = fmaxf(best, batch.weight[k]);
+        CHECK(best == 1.0f);
+    }
+
+    // O minilote sai ordenado por estado, com os pesos junto
+    bool sorted = true;
+    for (int k = 1; k < batch.n; k++) sorted = sorted && batch.state[k - 1] <= batch.state[k];
+    CHECK(sorted);
+
+    // p_max muito acima de todas as prioridades: toda aceitação falha e cada
+    // posição sai pelo fallback, ainda com o peso da sua própria prioridade
+    rb.maxPriority = 1e30f;
+    CHECK(replay_sample(&rb, &batch, REPLAY_TEST_BATCH, &rng) == REPLAY_TEST_BATCH);
+    CHECK(WeightsMatch(&rb, &batch));
+    rb.maxPriority = 0.05f + 31.0f / 8.0f;
+
+    // beta = 0: sem correção
+    rb.priorityBeta = 0.0f;
+    CHECK(replay_sample(&rb, &batch, REPLAY_TEST_BATCH, &rng) == REPLAY_TEST_BATCH);
+    ones = true;
+    for (int k = 0; k < batch.n; k++) ones = ones && batch.weight[k] == 1.0f;
+    CHECK(ones);
+
+    replay_free(&rb);
+}
@@ -0,0 +1,64 @@
+#include "check.h"
+#include "traces.h"
+#include <math.h>
+
+/*
+ * Tabela de traços: crescer preserva todos os traços (a mesma chave continua
+ * encontrada depois de cada realocação), as posições iniciais se espalham
+ * por todo o índice mesmo acima de 65536 posições, e aplicar soma cada traço
+ * na sua entrada da Q-table.
+ */
+
+#define TRACES_TEST_KEYS 100000
+
+void test_traces(void) {
+    TraceTable t;
+    CHECK(traces_init(&t, 16));
+
+    // Chaves state * Q_STRIDE + action distintas; a tabela cresce várias vezes
+    for (int i = 0; i < TRACES_TEST_KEYS; i++) CHECK(traces_set(&t, i, i % N_ACTIONS, 1.0f));
+    CHECK(t.count == TRACES_TEST_KEYS);
+    CHECK(t.capacity >= TRACES_TEST_KEYS);
+    CHECK(t.mask + 1 >= 2 * t.capacity);
+
+    // Regravar acha a entrada existente: nada é duplicado
+    for (int i = 0; i < TRACES_TEST_KEYS; i++) traces_set(&t, i, i % N_ACTIONS, 0.5f);
+    CHECK(t.count == TRACES_TEST_KEYS);
+    bool updated = true;
+    for (int i = 0; i < t.count; i++) updated = updated && t.values[i] == 0.5f;
+    CHECK(updated);
+
+    // Todas as chaves no índice, cada uma na entrada que o aponta
+    bool indexed = true;
+    for (int i = 0; i < t.count; i++) indexed = indexed && t.slots[t.where[i]] == i;
+    CHECK(indexed);
+
+    // Com o índice acima de 65536 posições, a metade de cima também recebe
+    // chaves (o hash usa os bits altos, não só 16)
+    CHECK(t.mask + 1 > 65536);
+    int upper = 0;
+    for (int i = 0; i < t.count; i++) upper += t.where[i] > t.mask / 2;
+    CHECK(upper > TRACES_TEST_KEYS / 4);
+    traces_free(&t);
+
+    // Aplicar: Q(s, a) += step * e, e o traço decai ou some
+    QTable *Q = init_q_table(NULL);
+    CHECK(Q != NULL);
+    if (!Q) return;
+    CHECK(traces_init(&t, 4));
+    float before[40];
+    for (int s = 0; s < 40; s++) {
+        before[s] = q_value(Q, s, s % N_ACTIONS);
+        traces_set(&t, s, s % N_ACTIONS, s < 20 ? 1.0f : 0.015f);
+    }
+    traces_apply(&t, Q, 2.0f, 0.5f, TRACE_MIN);
+    bool applied = true;
+    for (int s = 0; s < 40; s++) {
+        float expected = before[s] + (s < 20 ? 2.0f : 0.03f);
+        applied = applied && fabsf(q_value(Q, s, s % N_ACTIONS) - expected) < 1e-6f;
+    }
+    CHECK(applied);
+    CHECK(t.count == 20);   // 0.015 * 0.5 fica abaixo de TRACE_MIN
+    traces_free(&t);
+    free_q_table(Q);
+}
@@ -0,0 +1,181 @@
+/********************************************************************
+ * Gera assets_embedded.c com os sons e shaders do jogo (roda no build).
+ * Uso: embed_assets SAIDA.c ARQUIVO...
+ *   .wav → PCM de 16 bits (canais e taxa originais)
+ *   .fs/.vs → texto do shader terminado em '\0'
+ ********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WAVE_FORMAT_PCM        1
+#define WAVE_FORMAT_IEEE_FLOAT 3
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+typedef struct {
+    char name[64];
+    unsigned frames, rate, channels;
+} SoundInfo;
+
+static unsigned char *ReadFile(const char *path, long *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *buf = (unsigned char *)malloc((size_t)*size + 1);
+    if (buf && fread(buf, 1, (size_t)*size, f) != (size_t)*size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+
+static unsigned Le16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+static uint32_t Le32(const unsigned char *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+// Nome do arquivo sem diretório nem extensão, como identificador C
+static void BaseName(const char *path, char *out, size_t size) {
+    const char *slash = strrchr(path, '/');
+    const char *start = slash ? slash + 1 : path;
+    size_t n = 0;
+    for (const char *p = start; *p && *p != '.' && n + 1 < size; p++)
+        out[n++] = ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9')) ? *p : '_';
+    out[n] = '\0';
+}
+
+// Uma amostra em PCM de 16 bits (as mesmas conversões do dr_wav do raylib)
+static int16_t Sample16(const unsigned char *p, unsigned format, unsigned bits) {
+    if (format == WAVE_FORMAT_IEEE_FLOAT) {
+        float f;
+        uint32_t u = Le32(p);
+        memcpy(&f, &u, sizeof(f));
+        if (f > 1.0f) f = 1.0f;
+        if (f < -1.0f) f = -1.0f;
+        return (int16_t)(f * 32767.0f);
+    }
+    switch (bits) {
+        case 8:  return (int16_t)((p[0] - 128) << 8);
+        case 16: return (int16_t)Le16(p);
+        case 24: return (int16_t)(p[1] | (p[2] << 8));
+        default: return (int16_t)(Le32(p) >> 16);
+    }
+}
+
+static int EmbedWave(FILE *out, const char *path, SoundInfo *info) {
+    long size;
+    unsigned char *buf = ReadFile(path, &size);
+    if (!buf || size < 12 || memcmp(buf, "RIFF", 4) != 0 || memcmp(buf + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "embed_assets: %s não é um WAV\n", path);
+        free(buf);
+        return 0;
+    }
+    unsigned format = 0, channels = 0, rate = 0, bits = 0;
+    const unsigned char *data = NULL;
+    uint32_t dataSize = 0;
+    for (long pos = 12; pos + 8 <= size;) {
+        uint32_t chunk = Le32(buf + pos + 4);
+        const unsigned char *body = buf + pos + 8;
+        if (chunk > (uint32_t)(size - pos - 8)) chunk = (uint32_t)(size - pos - 8);
+        if (memcmp(buf + pos, "fmt ", 4) == 0 && chunk >= 16) {
+            format = Le16(body);
+            channels = Le16(body + 2);
+            rate = Le32(body + 4);
+            bits = Le16(body + 14);
+            if (format == WAVE_FORMAT_EXTENSIBLE && chunk >= 26) format = Le16(body + 24);
+        } else if (memcmp(buf + pos, "data", 4) == 0) {
+            data = body;
+            dataSize = chunk;
+        }
+        pos += 8 + chunk + (chunk & 1);
+    }
+    bool ok = data && channels > 0 && (format == WAVE_FORMAT_PCM || (format == WAVE_FORMAT_IEEE_FLOAT && bits == 32))
+              && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    if (!ok) {
+        fprintf(stderr, "embed_assets: %s: formato não suportado (tag %u, %u bits)\n", path, format, bits);
+        free(buf);
+        return 0;
+    }
+
+    unsigned stride = channels * bits / 8;
+    BaseName(path, info->name, sizeof(info->name));
+    info->frames = dataSize / stride;
+    info->rate = rate;
+    info->channels = channels;
+    fprintf(out, "\n// %s: %u quadros, %u Hz, %u canal(is), origem %u bits\n", path, info->frames, rate, channels, bits);
+    fprintf(out, "static const int16_t sound_%s[] = {", info->name);
+    unsigned long count = (unsigned long)info->frames * channels;
+    for (unsigned long i = 0; i < count; i++) {
+        fprintf(out, "%s%d,", (i % 16) ? " " : "\n    ", Sample16(data + i * (bits / 8), format, bits));
+    }
+    if (count == 0) fprintf(out, " 0");
+    fprintf(out, "\n};\n");
+    free(buf);
+    return 1;
+}
+
+static int EmbedShader(FILE *out, const char *path, char *name, size_t nameSize) {
+    long size;
+    unsigned char *buf = ReadFile(path, &size);
+    if (!buf) {
+        fprintf(stderr, "embed_assets: não foi possível ler %s\n", path);
+        return 0;
+    }
+    BaseName(path, name, nameSize);
+    fprintf(out, "\n// %s\nstatic const char shader_%s[] = {", path, name);
+    for (long i = 0; i < size; i++) fprintf(out, "%s0x%02x,", (i % 16) ? " " : "\n    ", buf[i]);
+    fprintf(out, "\n    0x00\n};\n");
+    free(buf);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s SAIDA.c ARQUIVO...\n", argv[0]);
+        return 1;
+    }
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        fprintf(stderr, "embed_assets: não foi possível criar %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(out, "/* Gerado por tools/embed_assets.c; não editar. */\n\n#include \"assets.h\"\n");
+
+    int inputs = argc - 2;
+    SoundInfo *sounds = (SoundInfo *)calloc(inputs > 0 ? inputs : 1, sizeof(SoundInfo));
+    char (*shaders)[64] = calloc(inputs > 0 ? inputs : 1, sizeof(*shaders));
+    int soundCount = 0, shaderCount = 0, ok = sounds && shaders;
+    for (int i = 2; i < argc && ok; i++) {
+        const char *ext = strrchr(argv[i], '.');
+        if (ext && strcmp(ext, ".wav") == 0) ok = EmbedWave(out, argv[i], &sounds[soundCount++]);
+        else if (ext && (strcmp(ext, ".fs") == 0 || strcmp(ext, ".vs") == 0))
+            ok = EmbedShader(out, argv[i], shaders[shaderCount++], sizeof(shaders[0]));
+        else {
+            fprintf(stderr, "embed_assets: extensão desconhecida: %s\n", argv[i]);
+            ok = 0;
+        }
+    }
+
+    if (ok) {
+        // Tabelas com ao menos um elemento: C99 não aceita vetores vazios
+        fprintf(out, "\nconst EmbeddedSound embeddedSounds[] = {\n");
+        for (int i = 0; i < soundCount; i++)
+            fprintf(out, "    { \"%s\", %uu, %uu, 16u, %uu, sound_%s },\n", sounds[i].name, sounds[i].frames,
+                    sounds[i].rate, sounds[i].channels, sounds[i].name);
+        if (soundCount == 0) fprintf(out, "    { \"\", 0u, 0u, 16u, 0u, 0 },\n");
+        fprintf(out, "};\nconst int embeddedSoundCount = %d;\n", soundCount);
+        fprintf(out, "\nconst EmbeddedShader embeddedShaders[] = {\n");
+        for (int i = 0; i < shaderCount; i++) fprintf(out, "    { \"%s\", shader_%s },\n", shaders[i], shaders[i]);
+        if (shaderCount == 0) fprintf(out, "    { \"\", 0 },\n");
+        fprintf(out, "};\nconst int embeddedShaderCount = %d;\n", shaderCount);
+    }
+    free(sounds);
+    free(shaders);
+    if (fclose(out) != 0) ok = 0;
+    if (!ok) remove(argv[1]);
+    return ok ? 0 : 1;
+}